@@ -0,0 +1,556 @@
+#ifndef AISDI_MAPS_AGGREGATETREEMAP_H
+#define AISDI_MAPS_AGGREGATETREEMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace aisdi
+{
+
+//monoids for AggregateTreeMap
+//an operation provides result_type, identity(), lift(key, value) turning an element
+//into a result and an associative operator() combining two results in key order
+template <typename Type>
+struct SumOp
+{
+  using result_type = Type;
+  static result_type identity() { return Type(); }
+  template <typename Key>
+  static result_type lift(const Key&, const Type& value) { return value; }
+  result_type operator()(const result_type& a, const result_type& b) const { return a + b; }
+};
+
+template <typename Type>
+struct MinOp
+{
+  using result_type = Type;
+  static result_type identity() { return std::numeric_limits<Type>::max(); }
+  template <typename Key>
+  static result_type lift(const Key&, const Type& value) { return value; }
+  result_type operator()(const result_type& a, const result_type& b) const { return b < a ? b : a; }
+};
+
+template <typename Type>
+struct MaxOp
+{
+  using result_type = Type;
+  static result_type identity() { return std::numeric_limits<Type>::lowest(); }
+  template <typename Key>
+  static result_type lift(const Key&, const Type& value) { return value; }
+  result_type operator()(const result_type& a, const result_type& b) const { return a < b ? b : a; }
+};
+
+//ordered map keeping the aggregate of every subtree in its root
+//balanced as a treap (random priorities and rotations), so all operations including
+//aggregate(lo, hi) take expected O(log n)
+//values can't be modified in place since that would bypass the aggregates, use insertOrAssign()
+template <typename KeyType, typename ValueType, typename Op = SumOp<ValueType>>
+class AggregateTreeMap
+{
+protected:
+  struct Node;
+
+public:
+  using key_type = KeyType;
+  using mapped_type = ValueType;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using aggregate_type = typename Op::result_type;
+  using size_type = std::size_t;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
+
+  class ConstIterator;
+  using iterator = ConstIterator;
+  using const_iterator = ConstIterator;
+
+  AggregateTreeMap(const Op& op = Op()) : _root(nullptr), _size(0), _seed(0x2545F4914F6CDD1Dull), _op(op) {}
+
+  AggregateTreeMap(std::initializer_list<value_type> list) : AggregateTreeMap()
+  {
+    for(auto &i : list) insertOrAssign(i.first, i.second);
+  }
+
+  AggregateTreeMap(const AggregateTreeMap& other) : _root(nullptr), _size(other._size), _seed(other._seed), _op(other._op)
+  {
+    _root = duplicateTree(nullptr, other._root);
+  }
+
+  AggregateTreeMap(AggregateTreeMap&& other) : _root(other._root), _size(other._size), _seed(other._seed), _op(other._op)
+  {
+    other._root = nullptr;
+    other._size = 0;
+  }
+
+  ~AggregateTreeMap(){ clear(); }
+
+  AggregateTreeMap& operator=(const AggregateTreeMap& other)
+  {
+    if(&other == this) return *this;
+
+    clear();
+    _op = other._op;
+    _root = duplicateTree(nullptr, other._root);
+    _size = other._size;
+
+    return *this;
+  }
+
+  AggregateTreeMap& operator=(AggregateTreeMap&& other)
+  {
+    if(&other == this) return *this;
+
+    clear();
+    _op = other._op;
+    _root = other._root;
+    _size = other._size;
+    other._root = nullptr;
+    other._size = 0;
+
+    return *this;
+  }
+
+  bool isEmpty() const
+  {
+    return !_size;
+  }
+
+  size_type getSize() const
+  {
+    return _size;
+  }
+
+  //returns true if a new element was created
+  bool insertOrAssign(const key_type& key, const mapped_type& value)
+  {
+    Node *parent = nullptr, **link = &_root;
+    while(*link != nullptr){
+        parent = *link;
+        if(key < parent->value.first) link = &parent->left;
+        else if(parent->value.first < key) link = &parent->right;
+        else{
+            parent->value.second = value;
+            refreshUp(parent);
+            return false;
+        }
+    }
+
+    Node *newNode = new Node(value_type(key, value), nextPriority());
+    newNode->parent = parent;
+    newNode->aggregate = _op.lift(newNode->value.first, newNode->value.second);
+    *link = newNode;
+    ++_size;
+
+    //restoring the heap order on priorities
+    while(newNode->parent != nullptr && newNode->parent->priority < newNode->priority) rotateUp(newNode);
+    refreshUp(newNode->parent);
+    return true;
+  }
+
+  const mapped_type& valueOf(const key_type& key) const
+  {
+    Node *node = search(key);
+    if(node == nullptr) throw std::out_of_range("ValueOf didn't find the element");
+    return node->value.second;
+  }
+
+  bool contains(const key_type& key) const
+  {
+    return search(key) != nullptr;
+  }
+
+  const_iterator find(const key_type& key) const
+  {
+    return const_iterator(this, search(key));
+  }
+
+  //first element whose key is not less than the given one
+  const_iterator lowerBound(const key_type& key) const
+  {
+    Node *node = _root, *result = nullptr;
+    while(node != nullptr){
+        if(node->value.first < key) node = node->right;
+        else{
+            result = node;
+            node = node->left;
+        }
+    }
+    return const_iterator(this, result);
+  }
+
+  void remove(const key_type& key)
+  {
+    Node *toRemove = search(key);
+    if(toRemove == nullptr) throw std::out_of_range("Remove didn't find the element");
+
+    //rotating the node down until it becomes a leaf
+    while(toRemove->left != nullptr || toRemove->right != nullptr){
+        Node *child = toRemove->left;
+        if(child == nullptr || (toRemove->right != nullptr && child->priority < toRemove->right->priority))
+            child = toRemove->right;
+        rotateUp(child);
+    }
+
+    Node *parent = toRemove->parent;
+    if(parent == nullptr) _root = nullptr;
+    else if(parent->left == toRemove) parent->left = nullptr;
+    else parent->right = nullptr;
+    delete toRemove;
+    --_size;
+
+    refreshUp(parent);
+  }
+
+  void remove(const const_iterator& it)
+  {
+    remove(it->first);
+  }
+
+  void clear()
+  {
+    erase(_root);
+    _root = nullptr;
+    _size = 0;
+  }
+
+  //combines values of all elements
+  aggregate_type aggregate() const
+  {
+    return aggregateOf(_root);
+  }
+
+  //combines, in key order, values of elements with keys in [lo, hi)
+  aggregate_type aggregate(const key_type& lo, const key_type& hi) const
+  {
+    if(!(lo < hi)) return Op::identity();
+
+    //the highest node inside the range, both bounds are searched below it
+    Node *top = _root;
+    while(top != nullptr){
+        if(top->value.first < lo) top = top->right;
+        else if(!(top->value.first < hi)) top = top->left;
+        else break;
+    }
+    if(top == nullptr) return Op::identity();
+
+    //every node not less than lo brings its right subtree along
+    aggregate_type lower = Op::identity();
+    for(Node *node = top->left; node != nullptr;){
+        if(node->value.first < lo) node = node->right;
+        else{
+            lower = _op(_op(liftOf(node), aggregateOf(node->right)), lower);
+            node = node->left;
+        }
+    }
+
+    //every node less than hi brings its left subtree along
+    aggregate_type upper = Op::identity();
+    for(Node *node = top->right; node != nullptr;){
+        if(!(node->value.first < hi)) node = node->left;
+        else{
+            upper = _op(upper, _op(aggregateOf(node->left), liftOf(node)));
+            node = node->right;
+        }
+    }
+
+    return _op(_op(lower, liftOf(top)), upper);
+  }
+
+  bool operator==(const AggregateTreeMap& other) const
+  {
+    if(_size != other._size) return false;
+    for(const_iterator it1 = cbegin(), it2 = other.cbegin(); it1 != cend(); ++it1, ++it2)
+        if( (it1->first != it2->first) || (it1->second != it2->second) ) return false;
+    return true;
+  }
+
+  bool operator!=(const AggregateTreeMap& other) const
+  {
+    return !(*this == other);
+  }
+
+  const_iterator cbegin() const
+  {
+    return const_iterator(this, _root != nullptr ? leftmost(_root) : nullptr);
+  }
+
+  const_iterator cend() const
+  {
+    return const_iterator(this, nullptr);
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+
+protected:
+  struct Node{
+    value_type value;
+    aggregate_type aggregate;
+    Node *left, *right, *parent;
+    std::uint32_t priority;
+
+    Node(const value_type &v, std::uint32_t p) : value(v), aggregate(Op::identity()), left(nullptr), right(nullptr), parent(nullptr), priority(p) {}
+  };
+  Node *_root;
+  size_type _size;
+  std::uint64_t _seed;
+  Op _op;
+
+  Node* search(const key_type &key) const
+  {
+    Node *node = _root;
+    while(node != nullptr){
+        if(key < node->value.first) node = node->left;
+        else if(node->value.first < key) node = node->right;
+        else return node;
+    }
+    return nullptr;
+  }
+
+  aggregate_type liftOf(const Node *node) const
+  {
+    return _op.lift(node->value.first, node->value.second);
+  }
+
+  static aggregate_type aggregateOf(const Node *node)
+  {
+    return node != nullptr ? node->aggregate : Op::identity();
+  }
+
+  void recompute(Node *node)
+  {
+    node->aggregate = _op(_op(aggregateOf(node->left), liftOf(node)), aggregateOf(node->right));
+  }
+
+  //recomputes aggregates from the given node up to the root
+  void refreshUp(Node *node)
+  {
+    for(; node != nullptr; node = node->parent) recompute(node);
+  }
+
+  //moves the node one level up keeping the key order, aggregates of both nodes are recomputed
+  void rotateUp(Node *node)
+  {
+    Node *parent = node->parent, *grandparent = parent->parent;
+    if(parent->left == node){
+        parent->left = node->right;
+        if(node->right != nullptr) node->right->parent = parent;
+        node->right = parent;
+    }
+    else{
+        parent->right = node->left;
+        if(node->left != nullptr) node->left->parent = parent;
+        node->left = parent;
+    }
+    parent->parent = node;
+    node->parent = grandparent;
+
+    if(grandparent == nullptr) _root = node;
+    else if(grandparent->left == parent) grandparent->left = node;
+    else grandparent->right = node;
+
+    recompute(parent);
+    recompute(node);
+  }
+
+  std::uint32_t nextPriority()
+  {
+    _seed ^= _seed << 13;
+    _seed ^= _seed >> 7;
+    _seed ^= _seed << 17;
+    return static_cast<std::uint32_t>(_seed >> 32);
+  }
+
+  static Node* leftmost(Node *node)
+  {
+    while(node->left != nullptr) node = node->left;
+    return node;
+  }
+
+  static Node* rightmost(Node *node)
+  {
+    while(node->right != nullptr) node = node->right;
+    return node;
+  }
+
+  Node* duplicateTree(Node *parent, const Node *other)
+  {
+    if(other == nullptr) return nullptr;
+
+    Node *newNode = new Node(other->value, other->priority);
+    newNode->aggregate = other->aggregate;
+    newNode->parent = parent;
+    newNode->left = duplicateTree(newNode, other->left);
+    newNode->right = duplicateTree(newNode, other->right);
+    return newNode;
+  }
+
+  void erase(Node *node)
+  {
+    if(node == nullptr) return;
+    erase(node->left);
+    erase(node->right);
+    delete node;
+  }
+};
+
+template <typename KeyType, typename ValueType, typename Op>
+class AggregateTreeMap<KeyType, ValueType, Op>::ConstIterator
+{
+public:
+  using reference = typename AggregateTreeMap::const_reference;
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = typename AggregateTreeMap::value_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const typename AggregateTreeMap::value_type*;
+
+  explicit ConstIterator(const AggregateTreeMap *tree = nullptr, Node *position = nullptr) : _tree(tree), _position(position) {}
+
+  ConstIterator& operator++()
+  {
+    if(_position == nullptr) throw std::out_of_range("Tried to iterate beyond the tree");
+
+    if(_position->right != nullptr){
+        _position = AggregateTreeMap::leftmost(_position->right);
+        return *this;
+    }
+    while(_position->parent != nullptr && _position == _position->parent->right) _position = _position->parent;
+    _position = _position->parent;
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator result = *this;
+    ++(*this);
+    return result;
+  }
+
+  ConstIterator& operator--()
+  {
+    //stepping back from end()
+    if(_position == nullptr){
+        if(_tree == nullptr || _tree->_root == nullptr) throw std::out_of_range("Tried to iterate beyond the tree");
+        _position = AggregateTreeMap::rightmost(_tree->_root);
+        return *this;
+    }
+
+    if(_position->left != nullptr){
+        _position = AggregateTreeMap::rightmost(_position->left);
+        return *this;
+    }
+    Node *node = _position;
+    while(node->parent != nullptr && node == node->parent->left) node = node->parent;
+    if(node->parent == nullptr) throw std::out_of_range("Tried to iterate beyond the tree");
+    _position = node->parent;
+    return *this;
+  }
+
+  ConstIterator operator--(int)
+  {
+    ConstIterator result = *this;
+    --(*this);
+    return result;
+  }
+
+  reference operator*() const
+  {
+    if(_position == nullptr) throw std::out_of_range("Tried to get the value of the end()");
+    return _position->value;
+  }
+
+  pointer operator->() const
+  {
+    return &this->operator*();
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return _position == other._position;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+
+private:
+  const AggregateTreeMap *_tree;
+  Node *_position;
+};
+
+//aggregate of half-open intervals used as IntervalTreeMap keys: the greatest interval end
+template <typename Point>
+struct IntervalEndOp
+{
+  using result_type = Point;
+  static result_type identity() { return std::numeric_limits<Point>::lowest(); }
+  template <typename Value>
+  static result_type lift(const std::pair<Point, Point>& interval, const Value&) { return interval.second; }
+  result_type operator()(const result_type& a, const result_type& b) const { return a < b ? b : a; }
+};
+
+//map from half-open intervals [start, end) ordered by start, with overlap queries
+//pruned by the greatest interval end kept in every subtree
+template <typename Point, typename ValueType>
+class IntervalTreeMap : public AggregateTreeMap<std::pair<Point, Point>, ValueType, IntervalEndOp<Point>>
+{
+  using Base = AggregateTreeMap<std::pair<Point, Point>, ValueType, IntervalEndOp<Point>>;
+  using Node = typename Base::Node;
+
+public:
+  using typename Base::key_type;
+  using typename Base::value_type;
+
+  using Base::Base;
+
+  //calls f(element) for every stored interval overlapping [lo, hi), in key order
+  template <typename Function>
+  void forEachOverlapping(const Point& lo, const Point& hi, Function f) const
+  {
+    if(lo < hi) visitOverlapping(this->_root, lo, hi, f);
+  }
+
+  //O(log n) check whether any stored interval overlaps [lo, hi)
+  bool overlapsAny(const Point& lo, const Point& hi) const
+  {
+    if(!(lo < hi)) return false;
+
+    const Node *node = this->_root;
+    while(node != nullptr){
+        if(node->value.first.first < hi && lo < node->value.first.second) return true;
+        //if the left subtree reaches past lo, either it holds an overlap or nothing to the right does
+        if(node->left != nullptr && lo < node->left->aggregate) node = node->left;
+        else node = node->right;
+    }
+    return false;
+  }
+
+private:
+  template <typename Function>
+  static void visitOverlapping(const Node *node, const Point& lo, const Point& hi, Function& f)
+  {
+    //nothing below ends after lo
+    if(node == nullptr || !(lo < node->aggregate)) return;
+
+    visitOverlapping(node->left, lo, hi, f);
+    //starts are ordered, the node and its right subtree begin at or past hi
+    if(!(node->value.first.first < hi)) return;
+    if(lo < node->value.first.second) f(node->value);
+    visitOverlapping(node->right, lo, hi, f);
+  }
+};
+
+}
+
+#endif /* AISDI_MAPS_AGGREGATETREEMAP_H */
@@ -0,0 +1,1136 @@
+#ifndef AISDI_MAPS_ARTMAP_H
+#define AISDI_MAPS_ARTMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace aisdi
+{
+
+//turns keys into byte strings whose lexicographic order is the key order
+//and where no key's bytes are a prefix of another key's bytes
+template <typename KeyType, typename Enable = void>
+struct ArtKeyTraits;
+
+//big-endian with the sign bit flipped, so negative numbers come first
+template <typename Integer>
+struct ArtKeyTraits<Integer, typename std::enable_if<std::is_integral<Integer>::value && !std::is_same<Integer, bool>::value>::type>
+{
+  static void encode(const Integer& key, std::string& out)
+  {
+    using Unsigned = typename std::make_unsigned<Integer>::type;
+    Unsigned bits = static_cast<Unsigned>(key);
+    if(std::is_signed<Integer>::value) bits ^= Unsigned(1) << (sizeof(Unsigned) * 8 - 1);
+    for(int shift = (sizeof(Unsigned) - 1) * 8; shift >= 0; shift -= 8) out.push_back(static_cast<char>((bits >> shift) & 0xFF));
+  }
+
+  static void encodePrefix(const Integer& key, std::string& out)
+  {
+    encode(key, out);
+  }
+};
+
+//0x00 is escaped as 0x00 0xFF and every key ends with 0x00 0x00
+template <>
+struct ArtKeyTraits<std::string>
+{
+  static void encodePrefix(const std::string& key, std::string& out)
+  {
+    for(char c : key){
+        out.push_back(c);
+        if(c == '\0') out.push_back('\xFF');
+    }
+  }
+
+  static void encode(const std::string& key, std::string& out)
+  {
+    encodePrefix(key, out);
+    out.push_back('\0');
+    out.push_back('\0');
+  }
+};
+
+//ordered map on an adaptive radix tree: inner nodes hold 4, 16, 48 or 256 children
+//depending on their fan-out and skip common key bytes with path compression
+//a lookup costs O(key length) no matter how many elements there are, and shared
+//key prefixes are stored and compared once
+template <typename KeyType, typename ValueType, typename Traits = ArtKeyTraits<KeyType>>
+class ArtMap
+{
+  struct Node;
+  struct Leaf;
+  struct Inner;
+
+public:
+  using key_type = KeyType;
+  using mapped_type = ValueType;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using size_type = std::size_t;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+
+  class ConstIterator;
+  class Iterator;
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+
+  ArtMap() : _root(nullptr), _size(0) {}
+
+  ArtMap(std::initializer_list<value_type> list) : ArtMap()
+  {
+    for(auto &i : list) (*this)[i.first] = i.second;
+  }
+
+  ArtMap(const ArtMap& other) : _root(duplicate(other._root)), _size(other._size) {}
+
+  ArtMap(ArtMap&& other) : _root(other._root), _size(other._size)
+  {
+    other._root = nullptr;
+    other._size = 0;
+  }
+
+  ~ArtMap(){ destroy(_root); }
+
+  ArtMap& operator=(const ArtMap& other)
+  {
+    if(&other == this) return *this;
+
+    Node *copy = duplicate(other._root);
+    destroy(_root);
+    _root = copy;
+    _size = other._size;
+
+    return *this;
+  }
+
+  ArtMap& operator=(ArtMap&& other)
+  {
+    if(&other == this) return *this;
+
+    destroy(_root);
+    _root = other._root;
+    _size = other._size;
+    other._root = nullptr;
+    other._size = 0;
+
+    return *this;
+  }
+
+  bool isEmpty() const
+  {
+    return !_size;
+  }
+
+  size_type getSize() const
+  {
+    return _size;
+  }
+
+  mapped_type& operator[](const key_type& key)
+  {
+    const std::string &bytes = encode(key);
+    return insert(&_root, key, bytes, 0)->value.second;
+  }
+
+  const mapped_type& valueOf(const key_type& key) const
+  {
+    Leaf *leaf = lookup(key, nullptr);
+    if(leaf == nullptr) throw std::out_of_range("ValueOf didn't find the element");
+    return leaf->value.second;
+  }
+
+  mapped_type& valueOf(const key_type& key)
+  {
+    Leaf *leaf = lookup(key, nullptr);
+    if(leaf == nullptr) throw std::out_of_range("ValueOf didn't find the element");
+    return leaf->value.second;
+  }
+
+  bool contains(const key_type& key) const
+  {
+    return lookup(key, nullptr) != nullptr;
+  }
+
+  const_iterator find(const key_type& key) const
+  {
+    const_iterator it(this);
+    it._leaf = lookup(key, &it._path);
+    if(it._leaf == nullptr) it._path.clear();
+    return it;
+  }
+
+  iterator find(const key_type& key)
+  {
+    return static_cast<const ArtMap*>(this)->find(key);
+  }
+
+  //first element whose key is not less than the given one
+  const_iterator lowerBound(const key_type& key) const
+  {
+    const_iterator it(this);
+    const std::string &bytes = encode(key);
+    const Node *node = _root;
+    size_type depth = 0;
+
+    while(node != nullptr){
+        if(node->type == LEAF){
+            const Leaf *leaf = static_cast<const Leaf*>(node);
+            it._leaf = const_cast<Leaf*>(leaf);
+            if(leaf->value.first < key) it.skipSubtree();
+            return it;
+        }
+
+        const Inner *inner = static_cast<const Inner*>(node);
+        int order = comparePrefix(inner, bytes, depth);
+        if(order > 0){
+            it.descendFirst(node);
+            return it;
+        }
+        if(order < 0){
+            it.skipSubtree();
+            return it;
+        }
+        depth += inner->prefixLength;
+
+        if(depth >= bytes.size()){
+            it.descendFirst(node);
+            return it;
+        }
+        unsigned char byte = bytes[depth];
+        int slot = slotNotLess(inner, byte);
+        if(slot < 0){
+            it.skipSubtree();
+            return it;
+        }
+        it._path.push_back(typename const_iterator::Frame{inner, slot});
+        node = childAt(inner, slot);
+        if(byteOfSlot(inner, slot) != byte){
+            it.descendFirst(node);
+            return it;
+        }
+        ++depth;
+    }
+    return cend();
+  }
+
+  //calls f(element) for every element whose key starts with the given prefix, in key order
+  template <typename Function>
+  void forEachWithPrefix(const key_type& prefix, Function f) const
+  {
+    std::string bytes;
+    Traits::encodePrefix(prefix, bytes);
+
+    const Node *node = _root;
+    size_type depth = 0;
+    while(node != nullptr && node->type != LEAF){
+        const Inner *inner = static_cast<const Inner*>(node);
+        size_type stored = inner->prefixLength < MAX_PREFIX ? inner->prefixLength : MAX_PREFIX;
+        for(size_type i = 0; i < stored && depth + i < bytes.size(); ++i)
+            if(static_cast<unsigned char>(bytes[depth + i]) != inner->prefix[i]) return;
+        depth += inner->prefixLength;
+        if(depth >= bytes.size()) break;
+
+        int slot = findSlot(inner, bytes[depth]);
+        if(slot < 0) return;
+        node = childAt(inner, slot);
+        ++depth;
+    }
+    if(node == nullptr) return;
+
+    //all keys below share their first bytes, one of them verifies the skipped ones
+    if(leafBytes(node).compare(0, bytes.size(), bytes) != 0) return;
+    visit(node, f);
+  }
+
+  void remove(const key_type& key)
+  {
+    const std::string &bytes = encode(key);
+    if(!removeFrom(&_root, key, bytes, 0)) throw std::out_of_range("Remove didn't find the element");
+    --_size;
+  }
+
+  void remove(const const_iterator& it)
+  {
+    remove(it->first);
+  }
+
+  void clear()
+  {
+    destroy(_root);
+    _root = nullptr;
+    _size = 0;
+  }
+
+  bool operator==(const ArtMap& other) const
+  {
+    if(_size != other._size) return false;
+    for(const_iterator it1 = cbegin(), it2 = other.cbegin(); it1 != cend(); ++it1, ++it2)
+        if( (it1->first != it2->first) || (it1->second != it2->second) ) return false;
+    return true;
+  }
+
+  bool operator!=(const ArtMap& other) const
+  {
+    return !(*this == other);
+  }
+
+  iterator begin()
+  {
+    return cbegin();
+  }
+
+  iterator end()
+  {
+    return cend();
+  }
+
+  const_iterator cbegin() const
+  {
+    const_iterator it(this);
+    if(_root != nullptr) it.descendFirst(_root);
+    return it;
+  }
+
+  const_iterator cend() const
+  {
+    return const_iterator(this);
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+
+private:
+  enum NodeType : std::uint8_t { LEAF, NODE4, NODE16, NODE48, NODE256 };
+
+  //inner nodes keep up to this many bytes of their compressed path, longer paths
+  //are checked against a leaf below when it matters
+  static const size_type MAX_PREFIX = 8;
+
+  struct Node{
+    NodeType type;
+    explicit Node(NodeType t) : type(t) {}
+  };
+
+  struct Leaf : Node{
+    value_type value;
+
+    template <typename... Args>
+    Leaf(const key_type &key, Args&&... args)
+      : Node(LEAF), value(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)) {}
+  };
+
+  struct Inner : Node{
+    std::uint16_t count;
+    std::uint32_t prefixLength;
+    unsigned char prefix[MAX_PREFIX];
+
+    explicit Inner(NodeType t) : Node(t), count(0), prefixLength(0) {}
+  };
+
+  //children sorted by key byte
+  struct Node4 : Inner{
+    unsigned char keys[4];
+    Node *children[4];
+    Node4() : Inner(NODE4) {}
+  };
+
+  struct Node16 : Inner{
+    unsigned char keys[16];
+    Node *children[16];
+    Node16() : Inner(NODE16) {}
+  };
+
+  //childIndex holds a position in children plus one, 0 means no child
+  struct Node48 : Inner{
+    unsigned char childIndex[256];
+    Node *children[48];
+    Node48() : Inner(NODE48)
+    {
+      std::memset(childIndex, 0, sizeof(childIndex));
+      std::memset(children, 0, sizeof(children));
+    }
+  };
+
+  struct Node256 : Inner{
+    Node *children[256];
+    Node256() : Inner(NODE256) { std::memset(children, 0, sizeof(children)); }
+  };
+
+  Node *_root;
+  size_type _size;
+
+  //the key's bytes in a buffer the thread reuses, valid until its next call; elements are
+  //constructed and destroyed only after the last read of them, as that may use another
+  //map of the same type
+  static const std::string& encode(const key_type &key)
+  {
+    static thread_local std::string buffer;
+    buffer.clear();
+    Traits::encode(key, buffer);
+    return buffer;
+  }
+
+  //second buffer reused the same way, for the bytes of a leaf's key
+  static std::string& leafBuffer()
+  {
+    static thread_local std::string buffer;
+    return buffer;
+  }
+
+  //the bytes of the smallest key below the node, for the parts of compressed paths
+  //the node doesn't store
+  static const std::string& leafBytes(const Node *node)
+  {
+    std::string &buffer = leafBuffer();
+    buffer.clear();
+    Traits::encode(minimumLeaf(node)->value.first, buffer);
+    return buffer;
+  }
+
+  //slots are positions in keys/children for Node4 and Node16, key bytes for the bigger nodes
+  static int findSlot(const Inner *node, unsigned char byte)
+  {
+    switch(node->type){
+    case NODE4:{
+        const Node4 *n = static_cast<const Node4*>(node);
+        for(int i = 0; i < n->count; ++i) if(n->keys[i] == byte) return i;
+        return -1;
+    }
+    case NODE16:{
+        const Node16 *n = static_cast<const Node16*>(node);
+#if defined(__SSE2__)
+        __m128i matches = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(n->keys)));
+        unsigned mask = _mm_movemask_epi8(matches) & ((1u << n->count) - 1);
+        return mask ? __builtin_ctz(mask) : -1;
+#else
+        for(int i = 0; i < n->count; ++i) if(n->keys[i] == byte) return i;
+        return -1;
+#endif
+    }
+    case NODE48:
+        return static_cast<const Node48*>(node)->childIndex[byte] ? byte : -1;
+    default:
+        return static_cast<const Node256*>(node)->children[byte] != nullptr ? byte : -1;
+    }
+  }
+
+  static Node*& childAt(const Inner *node, int slot)
+  {
+    Inner *n = const_cast<Inner*>(node);
+    switch(n->type){
+    case NODE4: return static_cast<Node4*>(n)->children[slot];
+    case NODE16: return static_cast<Node16*>(n)->children[slot];
+    case NODE48: return static_cast<Node48*>(n)->children[static_cast<Node48*>(n)->childIndex[slot] - 1];
+    default: return static_cast<Node256*>(n)->children[slot];
+    }
+  }
+
+  static unsigned char byteOfSlot(const Inner *node, int slot)
+  {
+    switch(node->type){
+    case NODE4: return static_cast<const Node4*>(node)->keys[slot];
+    case NODE16: return static_cast<const Node16*>(node)->keys[slot];
+    default: return static_cast<unsigned char>(slot);
+    }
+  }
+
+  //first slot holding a child with key byte not less than the given one, -1 if none
+  static int slotNotLess(const Inner *node, int byte)
+  {
+    switch(node->type){
+    case NODE4:{
+        const Node4 *n = static_cast<const Node4*>(node);
+        for(int i = 0; i < n->count; ++i) if(n->keys[i] >= byte) return i;
+        return -1;
+    }
+    case NODE16:{
+        const Node16 *n = static_cast<const Node16*>(node);
+        for(int i = 0; i < n->count; ++i) if(n->keys[i] >= byte) return i;
+        return -1;
+    }
+    case NODE48:{
+        const Node48 *n = static_cast<const Node48*>(node);
+        for(int b = byte; b < 256; ++b) if(n->childIndex[b]) return b;
+        return -1;
+    }
+    default:{
+        const Node256 *n = static_cast<const Node256*>(node);
+        for(int b = byte; b < 256; ++b) if(n->children[b] != nullptr) return b;
+        return -1;
+    }
+    }
+  }
+
+  //last slot holding a child with key byte not greater than the given one, -1 if none
+  static int slotNotGreater(const Inner *node, int byte)
+  {
+    switch(node->type){
+    case NODE4:{
+        const Node4 *n = static_cast<const Node4*>(node);
+        for(int i = n->count - 1; i >= 0; --i) if(n->keys[i] <= byte) return i;
+        return -1;
+    }
+    case NODE16:{
+        const Node16 *n = static_cast<const Node16*>(node);
+        for(int i = n->count - 1; i >= 0; --i) if(n->keys[i] <= byte) return i;
+        return -1;
+    }
+    case NODE48:{
+        const Node48 *n = static_cast<const Node48*>(node);
+        for(int b = byte; b >= 0; --b) if(n->childIndex[b]) return b;
+        return -1;
+    }
+    default:{
+        const Node256 *n = static_cast<const Node256*>(node);
+        for(int b = byte; b >= 0; --b) if(n->children[b] != nullptr) return b;
+        return -1;
+    }
+    }
+  }
+
+  static int nextSlot(const Inner *node, int slot)
+  {
+    if(node->type == NODE4 || node->type == NODE16) return slot + 1 < node->count ? slot + 1 : -1;
+    return slot < 255 ? slotNotLess(node, slot + 1) : -1;
+  }
+
+  static int previousSlot(const Inner *node, int slot)
+  {
+    if(node->type == NODE4 || node->type == NODE16) return slot - 1;
+    return slot > 0 ? slotNotGreater(node, slot - 1) : -1;
+  }
+
+  static const Leaf* minimumLeaf(const Node *node)
+  {
+    while(node->type != LEAF){
+        const Inner *inner = static_cast<const Inner*>(node);
+        node = childAt(inner, slotNotLess(inner, 0));
+    }
+    return static_cast<const Leaf*>(node);
+  }
+
+  //length of the part of the node's compressed path matching the key from depth on
+  //the bytes past the stored ones come from leafBytes(), which is left holding them
+  //whenever the result is MAX_PREFIX or more
+  static size_type prefixMismatch(const Inner *node, const std::string &bytes, size_type depth)
+  {
+    size_type stored = node->prefixLength < MAX_PREFIX ? node->prefixLength : MAX_PREFIX, i = 0;
+    for(; i < stored; ++i)
+        if(depth + i >= bytes.size() || static_cast<unsigned char>(bytes[depth + i]) != node->prefix[i]) return i;
+
+    if(node->prefixLength > MAX_PREFIX){
+        const std::string &leaf = leafBytes(node);
+        for(; i < node->prefixLength; ++i)
+            if(depth + i >= bytes.size() || bytes[depth + i] != leaf[depth + i]) return i;
+    }
+    return i;
+  }
+
+  //byte of the node's compressed path at the given position, right after prefixMismatch()
+  //matched that many bytes, so positions past the stored ones are in leafBuffer()
+  static unsigned char pathByte(const Inner *node, size_type depth, size_type position)
+  {
+    if(position < MAX_PREFIX) return node->prefix[position];
+    return static_cast<unsigned char>(leafBuffer()[depth + position]);
+  }
+
+  //compares the node's compressed path with the key bytes at the same depth
+  static int comparePrefix(const Inner *node, const std::string &bytes, size_type depth)
+  {
+    size_type matched = prefixMismatch(node, bytes, depth);
+    if(matched == node->prefixLength) return 0;
+    if(depth + matched >= bytes.size()) return 1;
+
+    return pathByte(node, depth, matched) < static_cast<unsigned char>(bytes[depth + matched]) ? -1 : 1;
+  }
+
+  //descends with optimistic path compression, the leaf decides in the end
+  //fills path (if given) with the nodes passed on the way
+  Leaf* lookup(const key_type &key, std::vector<typename ConstIterator::Frame> *path) const
+  {
+    const std::string &bytes = encode(key);
+    const Node *node = _root;
+    size_type depth = 0;
+    while(node != nullptr){
+        if(node->type == LEAF){
+            Leaf *leaf = const_cast<Leaf*>(static_cast<const Leaf*>(node));
+            return leaf->value.first == key ? leaf : nullptr;
+        }
+
+        const Inner *inner = static_cast<const Inner*>(node);
+        size_type stored = inner->prefixLength < MAX_PREFIX ? inner->prefixLength : MAX_PREFIX;
+        for(size_type i = 0; i < stored; ++i)
+            if(depth + i >= bytes.size() || static_cast<unsigned char>(bytes[depth + i]) != inner->prefix[i]) return nullptr;
+        depth += inner->prefixLength;
+        if(depth >= bytes.size()) return nullptr;
+
+        int slot = findSlot(inner, bytes[depth]);
+        if(slot < 0) return nullptr;
+        if(path != nullptr) path->push_back(typename ConstIterator::Frame{inner, slot});
+        node = childAt(inner, slot);
+        ++depth;
+    }
+    return nullptr;
+  }
+
+  static void copyHeader(Inner *to, const Inner *from)
+  {
+    to->count = from->count;
+    to->prefixLength = from->prefixLength;
+    std::memcpy(to->prefix, from->prefix, MAX_PREFIX);
+  }
+
+  //the node under *ref may be replaced by a bigger one
+  static void addChild(Node **ref, Inner *node, unsigned char byte, Node *child)
+  {
+    switch(node->type){
+    case NODE4:{
+        Node4 *n = static_cast<Node4*>(node);
+        if(n->count < 4){
+            int i = 0;
+            while(i < n->count && n->keys[i] < byte) ++i;
+            std::memmove(n->keys + i + 1, n->keys + i, n->count - i);
+            std::memmove(n->children + i + 1, n->children + i, (n->count - i) * sizeof(Node*));
+            n->keys[i] = byte;
+            n->children[i] = child;
+            ++n->count;
+            return;
+        }
+        Node16 *bigger = new Node16;
+        copyHeader(bigger, n);
+        std::memcpy(bigger->keys, n->keys, 4);
+        std::memcpy(bigger->children, n->children, 4 * sizeof(Node*));
+        *ref = bigger;
+        delete n;
+        addChild(ref, bigger, byte, child);
+        return;
+    }
+    case NODE16:{
+        Node16 *n = static_cast<Node16*>(node);
+        if(n->count < 16){
+            int i = 0;
+            while(i < n->count && n->keys[i] < byte) ++i;
+            std::memmove(n->keys + i + 1, n->keys + i, n->count - i);
+            std::memmove(n->children + i + 1, n->children + i, (n->count - i) * sizeof(Node*));
+            n->keys[i] = byte;
+            n->children[i] = child;
+            ++n->count;
+            return;
+        }
+        Node48 *bigger = new Node48;
+        copyHeader(bigger, n);
+        for(int i = 0; i < 16; ++i){
+            bigger->children[i] = n->children[i];
+            bigger->childIndex[n->keys[i]] = i + 1;
+        }
+        *ref = bigger;
+        delete n;
+        addChild(ref, bigger, byte, child);
+        return;
+    }
+    case NODE48:{
+        Node48 *n = static_cast<Node48*>(node);
+        if(n->count < 48){
+            int position = 0;
+            while(n->children[position] != nullptr) ++position;
+            n->children[position] = child;
+            n->childIndex[byte] = position + 1;
+            ++n->count;
+            return;
+        }
+        Node256 *bigger = new Node256;
+        copyHeader(bigger, n);
+        for(int b = 0; b < 256; ++b)
+            if(n->childIndex[b]) bigger->children[b] = n->children[n->childIndex[b] - 1];
+        *ref = bigger;
+        delete n;
+        addChild(ref, bigger, byte, child);
+        return;
+    }
+    default:{
+        Node256 *n = static_cast<Node256*>(node);
+        n->children[byte] = child;
+        ++n->count;
+        return;
+    }
+    }
+  }
+
+  //the node under *ref may be replaced by a smaller one or by its only child
+  static void removeChild(Node **ref, Inner *node, unsigned char byte)
+  {
+    switch(node->type){
+    case NODE4:{
+        Node4 *n = static_cast<Node4*>(node);
+        int i = findSlot(n, byte);
+        std::memmove(n->keys + i, n->keys + i + 1, n->count - i - 1);
+        std::memmove(n->children + i, n->children + i + 1, (n->count - i - 1) * sizeof(Node*));
+        if(--n->count == 1) collapse(ref, n);
+        return;
+    }
+    case NODE16:{
+        Node16 *n = static_cast<Node16*>(node);
+        int i = findSlot(n, byte);
+        std::memmove(n->keys + i, n->keys + i + 1, n->count - i - 1);
+        std::memmove(n->children + i, n->children + i + 1, (n->count - i - 1) * sizeof(Node*));
+        if(--n->count > 3) return;
+        Node4 *smaller = new Node4;
+        copyHeader(smaller, n);
+        std::memcpy(smaller->keys, n->keys, n->count);
+        std::memcpy(smaller->children, n->children, n->count * sizeof(Node*));
+        *ref = smaller;
+        delete n;
+        return;
+    }
+    case NODE48:{
+        Node48 *n = static_cast<Node48*>(node);
+        n->children[n->childIndex[byte] - 1] = nullptr;
+        n->childIndex[byte] = 0;
+        if(--n->count > 12) return;
+        Node16 *smaller = new Node16;
+        copyHeader(smaller, n);
+        int i = 0;
+        for(int b = 0; b < 256; ++b){
+            if(!n->childIndex[b]) continue;
+            smaller->keys[i] = static_cast<unsigned char>(b);
+            smaller->children[i++] = n->children[n->childIndex[b] - 1];
+        }
+        *ref = smaller;
+        delete n;
+        return;
+    }
+    default:{
+        Node256 *n = static_cast<Node256*>(node);
+        n->children[byte] = nullptr;
+        if(--n->count > 37) return;
+        Node48 *smaller = new Node48;
+        copyHeader(smaller, n);
+        int position = 0;
+        for(int b = 0; b < 256; ++b){
+            if(n->children[b] == nullptr) continue;
+            smaller->children[position] = n->children[b];
+            smaller->childIndex[b] = ++position;
+        }
+        *ref = smaller;
+        delete n;
+        return;
+    }
+    }
+  }
+
+  //replaces a Node4 with one child by that child, joining the compressed paths
+  static void collapse(Node **ref, Node4 *node)
+  {
+    Node *child = node->children[0];
+    if(child->type != LEAF){
+        Inner *inner = static_cast<Inner*>(child);
+        unsigned char joined[MAX_PREFIX];
+        size_type length = node->prefixLength < MAX_PREFIX ? node->prefixLength : MAX_PREFIX;
+        std::memcpy(joined, node->prefix, length);
+        if(length < MAX_PREFIX) joined[length++] = node->keys[0];
+        size_type childStored = inner->prefixLength < MAX_PREFIX ? inner->prefixLength : MAX_PREFIX;
+        for(size_type i = 0; i < childStored && length < MAX_PREFIX; ++i) joined[length++] = inner->prefix[i];
+
+        std::memcpy(inner->prefix, joined, length);
+        inner->prefixLength += node->prefixLength + 1;
+    }
+    *ref = child;
+    delete node;
+  }
+
+  Leaf* insert(Node **ref, const key_type &key, const std::string &bytes, size_type depth)
+  {
+    Node *node = *ref;
+    if(node == nullptr){
+        Leaf *leaf = new Leaf(key);
+        *ref = leaf;
+        ++_size;
+        return leaf;
+    }
+
+    if(node->type == LEAF){
+        Leaf *existing = static_cast<Leaf*>(node);
+        if(existing->value.first == key) return existing;
+
+        //both keys continue below a new node with their common bytes as its path
+        const std::string &existingBytes = leafBytes(existing);
+        size_type i = depth;
+        while(i < bytes.size() && i < existingBytes.size() && bytes[i] == existingBytes[i]) ++i;
+        if(i >= bytes.size() || i >= existingBytes.size()) throw std::logic_error("ArtMap key encoding is not prefix-free");
+
+        Node4 *split = new Node4;
+        split->prefixLength = static_cast<std::uint32_t>(i - depth);
+        for(size_type j = 0; j < split->prefixLength && j < MAX_PREFIX; ++j) split->prefix[j] = bytes[depth + j];
+        unsigned char own = existingBytes[i], byte = bytes[i];
+        Leaf *leaf = new Leaf(key);
+        addChild(ref, split, own, existing);
+        addChild(ref, split, byte, leaf);
+        *ref = split;
+        ++_size;
+        return leaf;
+    }
+
+    Inner *inner = static_cast<Inner*>(node);
+    if(inner->prefixLength){
+        size_type matched = prefixMismatch(inner, bytes, depth);
+        if(matched < inner->prefixLength){
+            if(depth + matched >= bytes.size()) throw std::logic_error("ArtMap key encoding is not prefix-free");
+
+            //the path is cut where the key departs from it
+            Node4 *split = new Node4;
+            split->prefixLength = static_cast<std::uint32_t>(matched);
+            std::memcpy(split->prefix, inner->prefix, matched < MAX_PREFIX ? matched : MAX_PREFIX);
+            unsigned char own = pathByte(inner, depth, matched), byte = bytes[depth + matched];
+
+            if(inner->prefixLength <= MAX_PREFIX){
+                inner->prefixLength -= matched + 1;
+                std::memmove(inner->prefix, inner->prefix + matched + 1, inner->prefixLength);
+            }
+            else{
+                //the rest of the path continues in the leaf's key, which prefixMismatch()
+                //has read already if the cut is past the stored bytes
+                const std::string &leafKey = matched >= MAX_PREFIX ? leafBuffer() : leafBytes(inner);
+                inner->prefixLength -= matched + 1;
+                size_type keep = inner->prefixLength < MAX_PREFIX ? inner->prefixLength : MAX_PREFIX;
+                std::memcpy(inner->prefix, leafKey.data() + depth + matched + 1, keep);
+            }
+
+            Leaf *leaf = new Leaf(key);
+            addChild(ref, split, own, inner);
+            addChild(ref, split, byte, leaf);
+            *ref = split;
+            ++_size;
+            return leaf;
+        }
+        depth += inner->prefixLength;
+    }
+
+    if(depth >= bytes.size()) throw std::logic_error("ArtMap key encoding is not prefix-free");
+    int slot = findSlot(inner, bytes[depth]);
+    if(slot >= 0) return insert(&childAt(inner, slot), key, bytes, depth + 1);
+
+    unsigned char byte = bytes[depth];
+    Leaf *leaf = new Leaf(key);
+    addChild(ref, inner, byte, leaf);
+    ++_size;
+    return leaf;
+  }
+
+  static bool removeFrom(Node **ref, const key_type &key, const std::string &bytes, size_type depth)
+  {
+    Node *node = *ref;
+    if(node == nullptr) return false;
+
+    if(node->type == LEAF){
+        if(!(static_cast<Leaf*>(node)->value.first == key)) return false;
+        delete static_cast<Leaf*>(node);
+        *ref = nullptr;
+        return true;
+    }
+
+    Inner *inner = static_cast<Inner*>(node);
+    size_type stored = inner->prefixLength < MAX_PREFIX ? inner->prefixLength : MAX_PREFIX;
+    for(size_type i = 0; i < stored; ++i)
+        if(depth + i >= bytes.size() || static_cast<unsigned char>(bytes[depth + i]) != inner->prefix[i]) return false;
+    depth += inner->prefixLength;
+    if(depth >= bytes.size()) return false;
+
+    unsigned char byte = bytes[depth];
+    int slot = findSlot(inner, byte);
+    if(slot < 0) return false;
+
+    Node *&child = childAt(inner, slot);
+    if(child->type != LEAF) return removeFrom(&child, key, bytes, depth + 1);
+
+    Leaf *leaf = static_cast<Leaf*>(child);
+    if(!(leaf->value.first == key)) return false;
+    delete leaf;
+    removeChild(ref, inner, byte);
+    return true;
+  }
+
+  template <typename Function>
+  static void visit(const Node *node, Function &f)
+  {
+    if(node->type == LEAF){
+        f(static_cast<const Leaf*>(node)->value);
+        return;
+    }
+    const Inner *inner = static_cast<const Inner*>(node);
+    for(int slot = slotNotLess(inner, 0); slot >= 0; slot = nextSlot(inner, slot)) visit(childAt(inner, slot), f);
+  }
+
+  static Node* duplicate(const Node *node)
+  {
+    if(node == nullptr) return nullptr;
+
+    switch(node->type){
+    case LEAF:
+        return new Leaf(*static_cast<const Leaf*>(node));
+    case NODE4:
+        return duplicateChildren(new Node4(*static_cast<const Node4*>(node)));
+    case NODE16:
+        return duplicateChildren(new Node16(*static_cast<const Node16*>(node)));
+    case NODE48:
+        return duplicateChildren(new Node48(*static_cast<const Node48*>(node)));
+    default:
+        return duplicateChildren(new Node256(*static_cast<const Node256*>(node)));
+    }
+  }
+
+  //the shallow copy still points at the original children
+  static Node* duplicateChildren(Inner *copy)
+  {
+    int slots[256], count = 0;
+    Node *originals[256];
+    for(int slot = slotNotLess(copy, 0); slot >= 0; slot = nextSlot(copy, slot)){
+        slots[count] = slot;
+        originals[count++] = childAt(copy, slot);
+    }
+    for(int i = 0; i < count; ++i) childAt(copy, slots[i]) = nullptr;
+    try{
+        for(int i = 0; i < count; ++i) childAt(copy, slots[i]) = duplicate(originals[i]);
+    }
+    catch(...){
+        destroy(copy);
+        throw;
+    }
+    return copy;
+  }
+
+  static void destroy(Node *node)
+  {
+    if(node == nullptr) return;
+
+    switch(node->type){
+    case LEAF:
+        delete static_cast<Leaf*>(node);
+        return;
+    case NODE4:
+        destroyChildren(static_cast<Node4*>(node));
+        delete static_cast<Node4*>(node);
+        return;
+    case NODE16:
+        destroyChildren(static_cast<Node16*>(node));
+        delete static_cast<Node16*>(node);
+        return;
+    case NODE48:
+        destroyChildren(static_cast<Node48*>(node));
+        delete static_cast<Node48*>(node);
+        return;
+    default:
+        destroyChildren(static_cast<Node256*>(node));
+        delete static_cast<Node256*>(node);
+        return;
+    }
+  }
+
+  static void destroyChildren(Inner *node)
+  {
+    for(int slot = slotNotLess(node, 0); slot >= 0; slot = nextSlot(node, slot)) destroy(childAt(node, slot));
+  }
+};
+
+template <typename KeyType, typename ValueType, typename Traits>
+class ArtMap<KeyType, ValueType, Traits>::ConstIterator
+{
+public:
+  using reference = typename ArtMap::const_reference;
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = typename ArtMap::value_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const typename ArtMap::value_type*;
+
+  explicit ConstIterator(const ArtMap *map = nullptr) : _map(map), _leaf(nullptr) {}
+
+  ConstIterator& operator++()
+  {
+    if(_leaf == nullptr) throw std::out_of_range("Tried to iterate beyond the map");
+    skipSubtree();
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator result = *this;
+    ++(*this);
+    return result;
+  }
+
+  ConstIterator& operator--()
+  {
+    if(_leaf == nullptr){
+        if(_map == nullptr || _map->_root == nullptr) throw std::out_of_range("Tried to iterate beyond the map");
+        descendLast(_map->_root);
+        return *this;
+    }
+
+    size_type depth = _path.size();
+    while(depth > 0){
+        Frame &frame = _path[depth - 1];
+        int slot = ArtMap::previousSlot(frame.node, frame.slot);
+        if(slot >= 0){
+            _path.resize(depth);
+            _path.back().slot = slot;
+            descendLast(ArtMap::childAt(frame.node, slot));
+            return *this;
+        }
+        --depth;
+    }
+    throw std::out_of_range("Tried to iterate beyond the map");
+  }
+
+  ConstIterator operator--(int)
+  {
+    ConstIterator result = *this;
+    --(*this);
+    return result;
+  }
+
+  reference operator*() const
+  {
+    if(_leaf == nullptr) throw std::out_of_range("Tried to get the value of the end()");
+    return _leaf->value;
+  }
+
+  pointer operator->() const
+  {
+    return &this->operator*();
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return _leaf == other._leaf;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+
+protected:
+  friend class ArtMap;
+
+  //an inner node on the way to the current leaf and the slot taken in it
+  struct Frame{
+    const Inner *node;
+    int slot;
+  };
+
+  const ArtMap *_map;
+  std::vector<Frame> _path;
+  Leaf *_leaf;
+
+  void descendFirst(const Node *node)
+  {
+    while(node->type != LEAF){
+        const Inner *inner = static_cast<const Inner*>(node);
+        int slot = ArtMap::slotNotLess(inner, 0);
+        _path.push_back(Frame{inner, slot});
+        node = ArtMap::childAt(inner, slot);
+    }
+    _leaf = const_cast<Leaf*>(static_cast<const Leaf*>(node));
+  }
+
+  void descendLast(const Node *node)
+  {
+    while(node->type != LEAF){
+        const Inner *inner = static_cast<const Inner*>(node);
+        int slot = ArtMap::slotNotGreater(inner, 255);
+        _path.push_back(Frame{inner, slot});
+        node = ArtMap::childAt(inner, slot);
+    }
+    _leaf = const_cast<Leaf*>(static_cast<const Leaf*>(node));
+  }
+
+  //moves to the first leaf after the subtree hanging from the deepest frame
+  void skipSubtree()
+  {
+    while(!_path.empty()){
+        Frame &frame = _path.back();
+        int slot = ArtMap::nextSlot(frame.node, frame.slot);
+        if(slot >= 0){
+            frame.slot = slot;
+            descendFirst(ArtMap::childAt(frame.node, slot));
+            return;
+        }
+        _path.pop_back();
+    }
+    _leaf = nullptr;
+  }
+};
+
+template <typename KeyType, typename ValueType, typename Traits>
+class ArtMap<KeyType, ValueType, Traits>::Iterator : public ArtMap<KeyType, ValueType, Traits>::ConstIterator
+{
+public:
+  using reference = typename ArtMap::reference;
+  using pointer = typename ArtMap::value_type*;
+
+  explicit Iterator() : ConstIterator()
+  {}
+
+  Iterator(const ConstIterator& other)
+    : ConstIterator(other)
+  {}
+
+  Iterator& operator++()
+  {
+    ConstIterator::operator++();
+    return *this;
+  }
+
+  Iterator operator++(int)
+  {
+    auto result = *this;
+    ConstIterator::operator++();
+    return result;
+  }
+
+  Iterator& operator--()
+  {
+    ConstIterator::operator--();
+    return *this;
+  }
+
+  Iterator operator--(int)
+  {
+    auto result = *this;
+    ConstIterator::operator--();
+    return result;
+  }
+
+  pointer operator->() const
+  {
+    return &this->operator*();
+  }
+
+  reference operator*() const
+  {
+    // ugly cast, yet reduces code duplication.
+    return const_cast<reference>(ConstIterator::operator*());
+  }
+};
+
+}
+
+#endif /* AISDI_MAPS_ARTMAP_H */
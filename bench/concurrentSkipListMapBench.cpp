@@ -0,0 +1,149 @@
+//throughput of ConcurrentSkipListMap against a TreeMap behind one mutex, the way a shared
+//ordered index is guarded without it, under a 90/10 read/write mix: 90% finds, 5% inserts
+//and 5% removes of random keys from a range filled to half beforehand
+//every run lasts a fixed time and counts the operations all threads completed
+//
+//  g++ -std=c++17 -O2 -DNDEBUG -pthread bench/concurrentSkipListMapBench.cpp -o bench
+//
+//usage: bench [max threads] [seconds per run] [keys]
+//thread counts double from 1 up to the maximum, which defaults to the number of cores
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../concurrentSkipListMap.h"
+#include "../treeMap.h"
+
+namespace
+{
+
+using Key = std::uint64_t;
+
+struct Random
+{
+  std::uint64_t state;
+
+  explicit Random(std::uint64_t seed) : state(seed * 0x9E3779B97F4A7C15ull + 1) {}
+
+  std::uint64_t next()
+  {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+  }
+};
+
+class SkipListSubject
+{
+public:
+  void insert(Key key) { _map.insert(key, key); }
+  void remove(Key key) { _map.remove(key); }
+  bool find(Key key) const { return _map.find(key) != _map.end(); }
+
+private:
+  aisdi::ConcurrentSkipListMap<Key, Key> _map;
+};
+
+class LockedTreeSubject
+{
+public:
+  void insert(Key key)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _map[key] = key;
+  }
+
+  void remove(Key key)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _map.find(key);
+    if(it != _map.end()) _map.remove(it);
+  }
+
+  bool find(Key key)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _map.find(key) != _map.end();
+  }
+
+private:
+  std::mutex _mutex;
+  aisdi::TreeMap<Key, Key> _map;
+};
+
+//returns completed operations per second
+template <typename Subject>
+double run(unsigned threads, double seconds, Key keys)
+{
+  Subject subject;
+  Random fill(0);
+  for(Key i = 0; i < keys / 2; ++i) subject.insert(fill.next() % keys);
+
+  std::atomic<bool> start(false), stop(false);
+  std::atomic<unsigned long> total(0);
+  //keeps the lookups from being optimized away
+  std::atomic<unsigned long> found(0);
+  std::vector<std::thread> workers;
+  for(unsigned t = 0; t < threads; ++t){
+      workers.emplace_back([&, t]{
+        Random random(t + 1);
+        unsigned long operations = 0, hits = 0;
+        while(!start.load(std::memory_order_acquire)) std::this_thread::yield();
+        while(!stop.load(std::memory_order_relaxed)){
+            for(int i = 0; i < 64; ++i){
+                std::uint64_t r = random.next();
+                Key key = (r >> 8) % keys;
+                unsigned kind = r % 20;
+                if(kind == 0) subject.insert(key);
+                else if(kind == 1) subject.remove(key);
+                else hits += subject.find(key);
+            }
+            operations += 64;
+        }
+        total.fetch_add(operations);
+        found.fetch_add(hits);
+      });
+  }
+
+  auto begin = std::chrono::steady_clock::now();
+  start.store(true, std::memory_order_release);
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  stop.store(true);
+  for(auto &w : workers) w.join();
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+  if(found.load() == 0) std::fprintf(stderr, "no lookup found its key\n");
+  return total.load() / elapsed;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+  unsigned cores = std::thread::hardware_concurrency();
+  unsigned maxThreads = argc > 1 ? std::atoi(argv[1]) : (cores ? cores : 1);
+  double seconds = argc > 2 ? std::atof(argv[2]) : 1.0;
+  Key keys = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1000000;
+  if(maxThreads == 0 || seconds <= 0 || keys < 2){
+      std::fprintf(stderr, "usage: %s [max threads] [seconds per run] [keys]\n", argv[0]);
+      return 2;
+  }
+
+  std::printf("90%% find, 5%% insert, 5%% remove over %llu keys, %u cores\n", static_cast<unsigned long long>(keys), cores);
+  std::printf("%8s %22s %22s %8s\n", "threads", "skip list Mops/s", "locked TreeMap Mops/s", "ratio");
+  for(unsigned threads = 1; ; threads *= 2){
+      if(threads > maxThreads) threads = maxThreads;
+      double skipList = run<SkipListSubject>(threads, seconds, keys) / 1e6;
+      double locked = run<LockedTreeSubject>(threads, seconds, keys) / 1e6;
+      std::printf("%8u %22.2f %22.2f %8.2f\n", threads, skipList, locked, skipList / locked);
+      if(threads == maxThreads) break;
+  }
+  return 0;
+}
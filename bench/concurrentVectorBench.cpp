@@ -0,0 +1,156 @@
+//contention benchmark of ConcurrentVector against a Vector behind one mutex, the way
+//producers share a log without it: producer threads append records as fast as they can
+//while reader threads keep polling the size and reading the newest published record
+//every producer appends the same number of records; the time until all of them are in
+//gives the append rate, the readers report how many polls they got through meanwhile
+//
+//  g++ -std=c++17 -O2 -DNDEBUG -pthread bench/concurrentVectorBench.cpp -o bench
+//
+//usage: bench [max producers] [readers] [appends per producer]
+//producer counts double from 1 up to the maximum, which defaults to the number of cores
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../concurrentVector.h"
+#include "../vector.h"
+
+namespace
+{
+
+struct Record
+{
+  std::uint64_t producer;
+  std::uint64_t sequence;
+};
+
+class ConcurrentSubject
+{
+public:
+  void append(const Record &record) { _records.append(record); }
+
+  //size and the newest record, {0, {}} while empty
+  std::size_t poll(Record &newest) const
+  {
+    std::size_t size = _records.getSize();
+    if(size) newest = _records[size - 1];
+    return size;
+  }
+
+private:
+  aisdi::ConcurrentVector<Record> _records;
+};
+
+class LockedSubject
+{
+public:
+  void append(const Record &record)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _records.append(record);
+  }
+
+  std::size_t poll(Record &newest)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::size_t size = _records.getSize();
+    if(size) newest = _records[size - 1];
+    return size;
+  }
+
+private:
+  std::mutex _mutex;
+  aisdi::Vector<Record> _records;
+};
+
+struct Result
+{
+  double appendsPerSecond;
+  double pollsPerSecond;
+  bool consistent;
+};
+
+template <typename Subject>
+Result run(unsigned producers, unsigned readers, std::uint64_t appends)
+{
+  Subject subject;
+  std::atomic<bool> start(false), done(false), consistent(true);
+  std::atomic<unsigned long> polls(0);
+
+  std::vector<std::thread> readerThreads;
+  for(unsigned r = 0; r < readers; ++r){
+      readerThreads.emplace_back([&]{
+        unsigned long count = 0;
+        std::size_t last = 0;
+        while(!start.load(std::memory_order_acquire)) std::this_thread::yield();
+        while(!done.load(std::memory_order_acquire)){
+            Record newest{0, 0};
+            std::size_t size = subject.poll(newest);
+            //the size never shrinks and the newest record is a complete one
+            if(size < last || (size && (newest.producer >= producers || newest.sequence >= appends))) consistent.store(false);
+            last = size;
+            ++count;
+        }
+        polls.fetch_add(count);
+      });
+  }
+
+  std::vector<std::thread> producerThreads;
+  for(unsigned p = 0; p < producers; ++p){
+      producerThreads.emplace_back([&, p]{
+        while(!start.load(std::memory_order_acquire)) std::this_thread::yield();
+        for(std::uint64_t i = 0; i < appends; ++i) subject.append(Record{p, i});
+      });
+  }
+
+  auto begin = std::chrono::steady_clock::now();
+  start.store(true, std::memory_order_release);
+  for(auto &t : producerThreads) t.join();
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  done.store(true, std::memory_order_release);
+  for(auto &t : readerThreads) t.join();
+
+  Record newest;
+  if(subject.poll(newest) != producers * appends) consistent.store(false);
+  return Result{producers * appends / elapsed, polls.load() / elapsed, consistent.load()};
+}
+
+}
+
+int main(int argc, char **argv)
+{
+  unsigned cores = std::thread::hardware_concurrency();
+  unsigned maxProducers = argc > 1 ? std::atoi(argv[1]) : (cores ? cores : 1);
+  unsigned readers = argc > 2 ? std::atoi(argv[2]) : 2;
+  std::uint64_t appends = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 2000000;
+  if(maxProducers == 0 || appends == 0){
+      std::fprintf(stderr, "usage: %s [max producers] [readers] [appends per producer]\n", argv[0]);
+      return 2;
+  }
+
+  std::printf("%llu appends of %zu byte records per producer, %u readers polling, %u cores\n",
+              static_cast<unsigned long long>(appends), sizeof(Record), readers, cores);
+  std::printf("%9s %20s %20s %20s %20s\n", "producers", "concurrent Mapp/s", "locked Mapp/s", "concurrent Mpoll/s", "locked Mpoll/s");
+  bool consistent = true;
+  for(unsigned producers = 1; ; producers *= 2){
+      if(producers > maxProducers) producers = maxProducers;
+      Result concurrent = run<ConcurrentSubject>(producers, readers, appends);
+      Result locked = run<LockedSubject>(producers, readers, appends);
+      std::printf("%9u %20.2f %20.2f %20.2f %20.2f\n", producers,
+                  concurrent.appendsPerSecond / 1e6, locked.appendsPerSecond / 1e6,
+                  concurrent.pollsPerSecond / 1e6, locked.pollsPerSecond / 1e6);
+      consistent = consistent && concurrent.consistent && locked.consistent;
+      if(producers == maxProducers) break;
+  }
+  if(!consistent){
+      std::fprintf(stderr, "a reader saw an inconsistent state\n");
+      return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,168 @@
+//PriorityQueue with Arity 2 and 4 against std::priority_queue, for 8 byte keys and for
+//32 byte records ordered by a key, on two workloads:
+//  fill and drain: n pushes of random keys, then n pops
+//  steady: a queue of n elements popped and pushed again n times (a scheduler's pattern)
+//times are nanoseconds per element pushed and popped, the best of a few repetitions;
+//every queue has to pop the same keys, which is checked
+//
+//  g++ -std=c++17 -O2 -DNDEBUG bench/priorityQueueBench.cpp -o bench
+//
+//usage: bench [sizes...], 1000 100000 1000000 by default
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "../priorityQueue.h"
+
+namespace
+{
+
+const int REPETITIONS = 3;
+
+struct Record
+{
+  std::uint64_t key;
+  std::uint64_t payload[3];
+
+  explicit Record(std::uint64_t k = 0) : key(k), payload{k, k, k} {}
+
+  bool operator<(const Record &other) const
+  {
+    return key < other.key;
+  }
+};
+
+std::uint64_t keyOf(std::uint64_t key)
+{
+  return key;
+}
+
+std::uint64_t keyOf(const Record &record)
+{
+  return record.key;
+}
+
+std::vector<std::uint64_t> randomKeys(std::size_t count, std::uint64_t seed)
+{
+  std::vector<std::uint64_t> keys(count);
+  std::uint64_t state = seed * 0x9E3779B97F4A7C15ull + 1;
+  for(auto &k : keys){
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      k = state;
+  }
+  return keys;
+}
+
+//the same interface over both kinds of queue
+template <typename T>
+struct StdQueue
+{
+  std::priority_queue<T> queue;
+
+  void push(const T &item) { queue.push(item); }
+  T pop()
+  {
+    T top = queue.top();
+    queue.pop();
+    return top;
+  }
+};
+
+template <typename T, std::size_t Arity>
+struct AisdiQueue
+{
+  aisdi::PriorityQueue<T, std::less<T>, Arity> queue;
+
+  void push(const T &item) { queue.push(item); }
+  T pop() { return queue.pop(); }
+};
+
+struct Timing
+{
+  double nanoseconds;
+  std::uint64_t checksum;
+};
+
+template <typename Queue, typename T>
+Timing fillAndDrain(const std::vector<std::uint64_t> &keys)
+{
+  Timing best{1e300, 0};
+  for(int r = 0; r < REPETITIONS; ++r){
+      Queue q;
+      std::uint64_t checksum = 0;
+      auto begin = std::chrono::steady_clock::now();
+      for(auto k : keys) q.push(T(k));
+      for(std::size_t i = 0; i < keys.size(); ++i) checksum = checksum * 31 + keyOf(q.pop());
+      double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / keys.size();
+      if(ns < best.nanoseconds) best.nanoseconds = ns;
+      best.checksum = checksum;
+  }
+  return best;
+}
+
+template <typename Queue, typename T>
+Timing steady(const std::vector<std::uint64_t> &keys, const std::vector<std::uint64_t> &next)
+{
+  Timing best{1e300, 0};
+  for(int r = 0; r < REPETITIONS; ++r){
+      Queue q;
+      for(auto k : keys) q.push(T(k));
+      std::uint64_t checksum = 0;
+      auto begin = std::chrono::steady_clock::now();
+      for(auto k : next){
+          checksum = checksum * 31 + keyOf(q.pop());
+          q.push(T(k));
+      }
+      double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / next.size();
+      if(ns < best.nanoseconds) best.nanoseconds = ns;
+      best.checksum = checksum;
+  }
+  return best;
+}
+
+bool report(const char *type, const char *workload, std::size_t size, Timing std, Timing binary, Timing quaternary)
+{
+  std::printf("%-8s %-15s %10zu %12.1f %12.1f %12.1f\n", type, workload, size, std.nanoseconds, binary.nanoseconds, quaternary.nanoseconds);
+  return std.checksum == binary.checksum && std.checksum == quaternary.checksum;
+}
+
+template <typename T>
+bool runAll(const char *type, std::size_t size)
+{
+  std::vector<std::uint64_t> keys = randomKeys(size, 1), next = randomKeys(size, 2);
+  bool same = report(type, "fill and drain", size,
+                     fillAndDrain<StdQueue<T>, T>(keys), fillAndDrain<AisdiQueue<T, 2>, T>(keys), fillAndDrain<AisdiQueue<T, 4>, T>(keys));
+  same = report(type, "steady", size,
+                steady<StdQueue<T>, T>(keys, next), steady<AisdiQueue<T, 2>, T>(keys, next), steady<AisdiQueue<T, 4>, T>(keys, next)) && same;
+  return same;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+  std::vector<std::size_t> sizes;
+  for(int i = 1; i < argc; ++i) sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+  if(sizes.empty()) sizes = {1000, 100000, 1000000};
+
+  std::printf("nanoseconds per element pushed and popped\n");
+  std::printf("%-8s %-15s %10s %12s %12s %12s\n", "type", "workload", "size", "std", "Arity 2", "Arity 4");
+  bool same = true;
+  for(auto size : sizes){
+      if(size == 0) continue;
+      same = runAll<std::uint64_t>("uint64", size) && same;
+      same = runAll<Record>("record", size) && same;
+  }
+  if(!same){
+      std::fprintf(stderr, "the queues popped different keys\n");
+      return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,225 @@
+//the kernels of simdKernels.h at every instruction set the processor supports, against the
+//plain loops they fall back to, on random arrays of 8, 32 and 64 bit integers, floats and
+//doubles: find (of a missing value, so the whole array is read), countIf with std::less,
+//minmax, sum and dot
+//every kernel runs on an array that fits in the L1 cache and on one four times bigger than
+//a usual last level cache; times are billions of elements per second, the best of a few
+//repetitions; every level has to return what the plain loop does (sums and dots of floats
+//up to rounding), which is checked
+//the plain loop is compiled with the flags of the benchmark, -O2 may vectorize some of it
+//with SSE2 already
+//
+//  g++ -std=c++17 -O2 -DNDEBUG bench/simdKernelsBench.cpp -o bench
+//
+//usage: bench [small bytes] [large bytes], 16384 and 134217728 by default
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+#include "../simdKernels.h"
+
+namespace
+{
+
+using aisdi::simd::Level;
+using aisdi::simd::SumType;
+
+const int REPETITIONS = 3;
+//elements every timing goes through, in as many calls as the array size needs
+const std::size_t ELEMENTS_PER_TIMING = std::size_t(1) << 26;
+
+const Level LEVELS[] = {Level::SCALAR, Level::SSE2, Level::AVX2, Level::AVX512};
+const char *const LEVEL_NAMES[] = {"scalar", "SSE2", "AVX2", "AVX-512"};
+
+//the kernel of a given level, called directly instead of through the dispatch
+template <typename T>
+std::size_t findAt(Level level, const T *p, std::size_t n, T value)
+{
+  namespace d = aisdi::simd::detail;
+  switch(level){
+#if AISDI_SIMD_X86
+  case Level::AVX512: return d::findAvx512(p, n, value);
+  case Level::AVX2: return d::findAvx2(p, n, value);
+  case Level::SSE2: return d::findSse2(p, n, value);
+#endif
+  default: return d::findScalar(p, n, value);
+  }
+}
+
+template <typename T>
+std::size_t countIfAt(Level level, const T *p, std::size_t n, T bound)
+{
+  namespace d = aisdi::simd::detail;
+  switch(level){
+#if AISDI_SIMD_X86
+  case Level::AVX512: return d::countIfAvx512(p, n, bound, std::less<T>());
+  case Level::AVX2: return d::countIfAvx2(p, n, bound, std::less<T>());
+  case Level::SSE2: return d::countIfSse2(p, n, bound, std::less<T>());
+#endif
+  default: return d::countIfScalar(p, n, bound, std::less<T>());
+  }
+}
+
+template <typename T>
+std::pair<T, T> minmaxAt(Level level, const T *p, std::size_t n)
+{
+  namespace d = aisdi::simd::detail;
+  switch(level){
+#if AISDI_SIMD_X86
+  case Level::AVX512: return d::minmaxAvx512(p, n);
+  case Level::AVX2: return d::minmaxAvx2(p, n);
+  case Level::SSE2: return d::minmaxSse2(p, n);
+#endif
+  default: return d::minmaxScalar(p, n);
+  }
+}
+
+template <typename T>
+SumType<T> sumAt(Level level, const T *p, std::size_t n)
+{
+  namespace d = aisdi::simd::detail;
+  switch(level){
+#if AISDI_SIMD_X86
+  case Level::AVX512: return d::sumAvx512(p, n);
+  case Level::AVX2: return d::sumAvx2(p, n);
+  case Level::SSE2: return d::sumSse2(p, n);
+#endif
+  default: return d::sumScalar(p, n);
+  }
+}
+
+template <typename T>
+SumType<T> dotAt(Level level, const T *a, const T *b, std::size_t n)
+{
+  namespace d = aisdi::simd::detail;
+  switch(level){
+#if AISDI_SIMD_X86
+  case Level::AVX512: return d::dotAvx512(a, b, n);
+  case Level::AVX2: return d::dotAvx2(a, b, n);
+  case Level::SSE2: return d::dotSse2(a, b, n);
+#endif
+  default: return d::dotScalar(a, b, n);
+  }
+}
+
+//random values; floats in [-1, 1)
+template <typename T>
+std::vector<T> randomArray(std::size_t count, std::uint64_t seed)
+{
+  std::vector<T> values(count);
+  std::uint64_t state = seed * 0x9E3779B97F4A7C15ull + 1;
+  for(auto &v : values){
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      if constexpr(std::is_floating_point<T>::value) v = static_cast<T>(static_cast<double>(state >> 11) / 4503599627370496.0 - 1);
+      else v = static_cast<T>(state);
+  }
+  return values;
+}
+
+//floating point results may differ by rounding, which grows with the sum of the magnitudes
+//of the terms, 'scale'
+template <typename T>
+bool close(T a, T b, double scale)
+{
+  if constexpr(std::is_floating_point<T>::value) return std::fabs(static_cast<double>(a) - static_cast<double>(b)) <= 1e-4 * scale;
+  else{
+      (void)scale;
+      return a == b;
+  }
+}
+
+//billions of elements per second; 'kernel' returns whether its result was the expected one
+template <typename Kernel>
+double rate(std::size_t n, bool &correct, Kernel kernel)
+{
+  const std::size_t calls = ELEMENTS_PER_TIMING / n ? ELEMENTS_PER_TIMING / n : 1;
+  double best = 0;
+  for(int r = 0; r < REPETITIONS; ++r){
+      bool ok = true;
+      auto begin = std::chrono::steady_clock::now();
+      for(std::size_t c = 0; c < calls; ++c){
+          ok = kernel() && ok;
+          //keeps the calls from being merged
+          asm volatile("" ::: "memory");
+      }
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+      double elements = static_cast<double>(calls) * n / seconds / 1e9;
+      if(elements > best) best = elements;
+      correct = correct && ok;
+  }
+  return best;
+}
+
+template <typename T>
+bool runAll(const char *type, std::size_t bytes)
+{
+  const std::size_t n = bytes / sizeof(T);
+  std::vector<T> a = randomArray<T>(n, 1), b = randomArray<T>(n, 2);
+  //a value none of the elements has, find reads the whole array
+  T missing = a[0];
+  for(auto &v : a)
+      if(v == missing) v = static_cast<T>(v + 1);
+  T bound = b[0];
+
+  const std::size_t expectedFind = findAt(Level::SCALAR, a.data(), n, missing);
+  const std::size_t expectedCount = countIfAt(Level::SCALAR, a.data(), n, bound);
+  const std::pair<T, T> expectedMinmax = minmaxAt(Level::SCALAR, a.data(), n);
+  const SumType<T> expectedSum = sumAt(Level::SCALAR, a.data(), n);
+  const SumType<T> expectedDot = dotAt(Level::SCALAR, a.data(), b.data(), n);
+  double sumScale = 0, dotScale = 0;
+  for(std::size_t i = 0; i < n; ++i){
+      sumScale += std::fabs(static_cast<double>(a[i]));
+      dotScale += std::fabs(static_cast<double>(a[i]) * static_cast<double>(b[i]));
+  }
+
+  bool correct = true;
+  for(std::size_t l = 0; l < sizeof(LEVELS) / sizeof(LEVELS[0]); ++l){
+      const Level level = LEVELS[l];
+      if(level > aisdi::simd::level()) break;
+      const T *pa = a.data(), *pb = b.data();
+      double find = rate(n, correct, [&]{ return findAt(level, pa, n, missing) == expectedFind; });
+      double countIf = rate(n, correct, [&]{ return countIfAt(level, pa, n, bound) == expectedCount; });
+      double minmax = rate(n, correct, [&]{ return minmaxAt(level, pa, n) == expectedMinmax; });
+      double sum = rate(n, correct, [&]{ return close(sumAt(level, pa, n), expectedSum, sumScale); });
+      double dot = rate(n, correct, [&]{ return close(dotAt(level, pa, pb, n), expectedDot, dotScale); });
+      std::printf("%-7s %11zu %-8s %9.2f %9.2f %9.2f %9.2f %9.2f\n", type, bytes, LEVEL_NAMES[l], find, countIf, minmax, sum, dot);
+  }
+  return correct;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+  std::size_t small = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16384;
+  std::size_t large = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::size_t(1) << 27;
+  if(small < 64 || large < 64){
+      std::fprintf(stderr, "usage: %s [small bytes] [large bytes], at least 64 each\n", argv[0]);
+      return 2;
+  }
+
+  std::printf("billions of elements per second, best instruction set: %s\n", LEVEL_NAMES[static_cast<int>(aisdi::simd::level())]);
+  std::printf("%-7s %11s %-8s %9s %9s %9s %9s %9s\n", "type", "bytes", "level", "find", "countIf", "minmax", "sum", "dot");
+  bool correct = true;
+  for(std::size_t bytes : {small, large}){
+      correct = runAll<std::int8_t>("int8", bytes) && correct;
+      correct = runAll<std::uint8_t>("uint8", bytes) && correct;
+      correct = runAll<std::int16_t>("int16", bytes) && correct;
+      correct = runAll<std::int32_t>("int32", bytes) && correct;
+      correct = runAll<std::int64_t>("int64", bytes) && correct;
+      correct = runAll<float>("float", bytes) && correct;
+      correct = runAll<double>("double", bytes) && correct;
+  }
+  if(!correct){
+      std::fprintf(stderr, "a kernel disagreed with the plain loop\n");
+      return 1;
+  }
+  return 0;
+}
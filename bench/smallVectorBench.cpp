@@ -0,0 +1,157 @@
+//SmallVector with 8 inline elements against Vector, on vectors of a few elements:
+//  temporary: a vector is filled with k elements, summed and destroyed, over and over
+//  held: a million vectors of k elements are filled and kept, then all summed
+//heap allocations are counted by a replaced operator new; the elements are not trivially
+//copyable, as Vector keeps trivially copyable ones in malloc memory the counter can't see
+//times are nanoseconds per element, the best of a few repetitions; the sums are checked
+//
+//  g++ -std=c++17 -O2 -DNDEBUG bench/smallVectorBench.cpp -o bench
+//
+//usage: bench [element counts...], 1 4 8 16 64 by default
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "../smallVector.h"
+#include "../vector.h"
+
+namespace
+{
+
+std::size_t allocations = 0;
+
+}
+
+void* operator new(std::size_t size)
+{
+  ++allocations;
+  if(void *p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+namespace
+{
+
+const int REPETITIONS = 3;
+const std::size_t INLINE = 8;
+const std::size_t ELEMENTS = 4000000;
+const std::size_t HELD = 1000000;
+
+struct Item
+{
+  std::uint64_t value;
+
+  explicit Item(std::uint64_t v = 0) : value(v) {}
+  Item(const Item &other) : value(other.value) {}
+  Item(Item &&other) noexcept : value(other.value) {}
+  Item& operator=(const Item &other)
+  {
+    value = other.value;
+    return *this;
+  }
+};
+
+using Small = aisdi::SmallVector<Item, INLINE>;
+using Plain = aisdi::Vector<Item>;
+
+struct Result
+{
+  double nanoseconds;
+  double allocationsPerVector;
+  std::uint64_t sum;
+};
+
+template <typename V>
+std::uint64_t sumOf(const V &v)
+{
+  std::uint64_t sum = 0;
+  for(std::size_t i = 0; i < v.getSize(); ++i) sum += v[i].value;
+  return sum;
+}
+
+template <typename V>
+Result temporary(std::size_t k)
+{
+  const std::size_t vectors = ELEMENTS / k;
+  Result best{1e300, 0, 0};
+  for(int r = 0; r < REPETITIONS; ++r){
+      std::uint64_t sum = 0;
+      std::size_t before = allocations;
+      auto begin = std::chrono::steady_clock::now();
+      for(std::size_t n = 0; n < vectors; ++n){
+          V v;
+          for(std::size_t i = 0; i < k; ++i) v.append(Item(n + i));
+          sum += sumOf(v);
+      }
+      double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / (vectors * k);
+      if(ns < best.nanoseconds) best.nanoseconds = ns;
+      best.allocationsPerVector = static_cast<double>(allocations - before) / vectors;
+      best.sum = sum;
+  }
+  return best;
+}
+
+//fill and sum are timed together, the allocations are those of the vectors' elements
+template <typename V>
+Result held(std::size_t k)
+{
+  Result best{1e300, 0, 0};
+  for(int r = 0; r < REPETITIONS; ++r){
+      std::vector<V> vectors(HELD);
+      std::uint64_t sum = 0;
+      std::size_t before = allocations;
+      auto begin = std::chrono::steady_clock::now();
+      for(std::size_t n = 0; n < HELD; ++n)
+          for(std::size_t i = 0; i < k; ++i) vectors[n].append(Item(n + i));
+      for(auto &v : vectors) sum += sumOf(v);
+      double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / (HELD * k);
+      if(ns < best.nanoseconds) best.nanoseconds = ns;
+      best.allocationsPerVector = static_cast<double>(allocations - before) / HELD;
+      best.sum = sum;
+  }
+  return best;
+}
+
+bool report(const char *workload, std::size_t k, Result small, Result plain)
+{
+  std::printf("%-10s %6zu %12.2f %12.2f %12.2f %12.2f\n", workload, k,
+              small.nanoseconds, plain.nanoseconds, small.allocationsPerVector, plain.allocationsPerVector);
+  return small.sum == plain.sum;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+  std::vector<std::size_t> counts;
+  for(int i = 1; i < argc; ++i) counts.push_back(std::strtoull(argv[i], nullptr, 10));
+  if(counts.empty()) counts = {1, 4, 8, 16, 64};
+
+  std::printf("nanoseconds per element and heap allocations per vector, SmallVector with %zu inline elements\n", INLINE);
+  std::printf("%-10s %6s %12s %12s %12s %12s\n", "workload", "k", "Small ns", "Vector ns", "Small allocs", "Vector allocs");
+  bool same = true;
+  for(auto k : counts){
+      if(k == 0) continue;
+      same = report("temporary", k, temporary<Small>(k), temporary<Plain>(k)) && same;
+      same = report("held", k, held<Small>(k), held<Plain>(k)) && same;
+  }
+  if(!same){
+      std::fprintf(stderr, "the vectors summed differently\n");
+      return 1;
+  }
+  return 0;
+}
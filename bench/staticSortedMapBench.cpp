@@ -0,0 +1,131 @@
+//lookups in a StaticSortedMap made by TreeMap::freeze() against the TreeMap itself
+//the keys are random and inserted in random order; a million random queries, half of
+//them keys of the map and half most likely missing, are timed on
+//  find: StaticSortedMap::find against TreeMap::find
+//  lowerBound: StaticSortedMap::lowerBound against std::lower_bound over a sorted array
+//  of the keys, as TreeMap has no lowerBound
+//times are nanoseconds per query, the best of a few repetitions; both sides of a pair
+//have to find the same elements, which is checked
+//
+//  g++ -std=c++17 -O2 -DNDEBUG bench/staticSortedMapBench.cpp -o bench
+//
+//usage: bench [sizes...], 1000000 10000000 100000000 by default
+//a TreeMap node takes about 64 bytes, 100M keys need 8 GB
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../staticSortedMap.h"
+#include "../treeMap.h"
+
+namespace
+{
+
+const int REPETITIONS = 3;
+const std::size_t QUERIES = 1000000;
+
+using Key = std::uint64_t;
+
+struct Random
+{
+  std::uint64_t state;
+
+  explicit Random(std::uint64_t seed) : state(seed * 0x9E3779B97F4A7C15ull + 1) {}
+
+  std::uint64_t next()
+  {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+  }
+};
+
+struct Timing
+{
+  double nanoseconds;
+  std::uint64_t checksum;
+};
+
+//runs lookup(query) over all queries, the checksum sums what the lookups return
+template <typename Lookup>
+Timing timeLookups(const std::vector<Key> &queries, Lookup lookup)
+{
+  Timing best{1e300, 0};
+  for(int r = 0; r < REPETITIONS; ++r){
+      std::uint64_t checksum = 0;
+      auto begin = std::chrono::steady_clock::now();
+      for(auto q : queries) checksum += lookup(q);
+      double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / queries.size();
+      if(ns < best.nanoseconds) best.nanoseconds = ns;
+      best.checksum = checksum;
+  }
+  return best;
+}
+
+bool runAll(std::size_t size)
+{
+  //the value of a key is its position in insertion order plus one, 0 stands for not found
+  Random random(size);
+  std::vector<Key> keys(size);
+  aisdi::TreeMap<Key, Key> tree;
+  for(std::size_t i = 0; i < size; ++i){
+      keys[i] = random.next();
+      tree[keys[i]] = i + 1;
+  }
+  aisdi::StaticSortedMap<Key, Key> frozen = tree.freeze();
+  std::vector<Key> sorted;
+  sorted.reserve(tree.getSize());
+  for(auto it = tree.begin(); it != tree.end(); ++it) sorted.push_back(it->first);
+
+  std::vector<Key> queries(QUERIES);
+  for(std::size_t i = 0; i < QUERIES; ++i) queries[i] = i % 2 ? keys[random.next() % size] : random.next();
+
+  Timing treeFind = timeLookups(queries, [&tree](Key q){
+      auto it = tree.find(q);
+      return it == tree.end() ? Key(0) : it->second;
+  });
+  Timing frozenFind = timeLookups(queries, [&frozen](Key q){
+      auto it = frozen.find(q);
+      return it == frozen.end() ? Key(0) : (*it).second;
+  });
+  Timing arrayLower = timeLookups(queries, [&sorted](Key q){
+      auto it = std::lower_bound(sorted.begin(), sorted.end(), q);
+      return it == sorted.end() ? Key(0) : *it;
+  });
+  Timing frozenLower = timeLookups(queries, [&frozen](Key q){
+      auto it = frozen.lowerBound(q);
+      return it == frozen.end() ? Key(0) : (*it).first;
+  });
+
+  std::printf("%10zu %12.1f %12.1f %8.2f %12.1f %12.1f %8.2f\n", size,
+              treeFind.nanoseconds, frozenFind.nanoseconds, treeFind.nanoseconds / frozenFind.nanoseconds,
+              arrayLower.nanoseconds, frozenLower.nanoseconds, arrayLower.nanoseconds / frozenLower.nanoseconds);
+  return treeFind.checksum == frozenFind.checksum && arrayLower.checksum == frozenLower.checksum;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+  std::vector<std::size_t> sizes;
+  for(int i = 1; i < argc; ++i) sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+  if(sizes.empty()) sizes = {1000000, 10000000, 100000000};
+
+  std::printf("nanoseconds per query, %zu random queries, half of them keys of the map\n", QUERIES);
+  std::printf("%10s %12s %12s %8s %12s %12s %8s\n", "size", "TreeMap find", "frozen find", "ratio", "array lower", "frozen lower", "ratio");
+  bool same = true;
+  for(auto size : sizes){
+      if(size == 0) continue;
+      same = runAll(size) && same;
+  }
+  if(!same){
+      std::fprintf(stderr, "the maps found different elements\n");
+      return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,365 @@
+#ifndef AISDI_LINEAR_BITVECTOR_H
+#define AISDI_LINEAR_BITVECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+
+#include "simdKernels.h"
+#include "vector.h"
+
+namespace aisdi
+{
+
+//vector of bits stored one per bit in 64-bit words, with rank (ones before a position)
+//and select (position of the k-th one) answered through a directory holding the number
+//of ones before every block of 512 bits
+//the directory is rebuilt by the first rank/select after a change, so those calls
+//must not race with each other until it's built
+class BitVector
+{
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = bool;
+
+  class ConstIterator;
+  using const_iterator = ConstIterator;
+
+  BitVector() : _size(0), _indexed(false) {}
+
+  bool operator[](size_type index) const
+  {
+    return (_words[index / 64] >> (index % 64)) & 1;
+  }
+
+  void set(size_type index, bool value)
+  {
+    if(index >= _size) throw std::out_of_range("Setting beyond the end()");
+    write(index, value);
+  }
+
+  bool isEmpty() const
+  {
+    return !_size;
+  }
+
+  size_type getSize() const
+  {
+    return _size;
+  }
+
+  //bytes taken by the bits and the rank directory
+  size_type getBytes() const
+  {
+    return (_words.capacity() + _ranks.capacity()) * sizeof(std::uint64_t);
+  }
+
+  void reserve(size_type count)
+  {
+    _words.reserve((count + 63) / 64);
+  }
+
+  void append(bool value)
+  {
+    if(_size % 64 == 0) _words.append(0);
+    write(_size++, value);
+  }
+
+  bool popLast()
+  {
+    if(isEmpty()) throw std::logic_error("Popping element when the vector is empty");
+
+    bool value = (*this)[_size - 1];
+    write(--_size, false);
+    if(_size % 64 == 0) _words.popLast();
+    return value;
+  }
+
+  void clear()
+  {
+    _words.clear();
+    _size = 0;
+    _indexed = false;
+  }
+
+  //the words holding the bits, bit i is bit i % 64 of word i / 64; bits past the end are zero
+  const std::uint64_t* data() const
+  {
+    return _words.data();
+  }
+
+  //number of ones
+  size_type count() const
+  {
+    return simd::popcount(_words.data(), _words.getSize());
+  }
+
+  //number of ones in [0, index)
+  size_type rank(size_type index) const
+  {
+    if(index > _size) throw std::out_of_range("Rank beyond the end()");
+    buildIndex();
+
+    size_type word = index / 64, block = word / WORDS_PER_BLOCK;
+    size_type ones = _ranks[block] + simd::popcount(_words.data() + block * WORDS_PER_BLOCK, word - block * WORDS_PER_BLOCK);
+    if(index % 64){
+        std::uint64_t masked = _words[word] & ((std::uint64_t(1) << (index % 64)) - 1);
+        ones += simd::popcount(&masked, 1);
+    }
+    return ones;
+  }
+
+  //number of zeros in [0, index)
+  size_type rank0(size_type index) const
+  {
+    return index - rank(index);
+  }
+
+  //position of the k-th one, counting from 0
+  size_type select(size_type k) const
+  {
+    return selectBit<true>(k);
+  }
+
+  //position of the k-th zero, counting from 0
+  size_type select0(size_type k) const
+  {
+    return selectBit<false>(k);
+  }
+
+  bool operator==(const BitVector& other) const
+  {
+    if(_size != other._size) return false;
+    for(size_type i = 0; i < _words.getSize(); ++i)
+        if(_words[i] != other._words[i]) return false;
+    return true;
+  }
+
+  bool operator!=(const BitVector& other) const
+  {
+    return !(*this == other);
+  }
+
+  const_iterator begin() const;
+  const_iterator end() const;
+  const_iterator cbegin() const;
+  const_iterator cend() const;
+
+private:
+  static constexpr size_type WORDS_PER_BLOCK = 8;
+
+  Vector<std::uint64_t> _words;
+  size_type _size;
+  //_ranks[b] is the number of ones in the blocks before b, the last entry is the total
+  mutable Vector<std::uint64_t> _ranks;
+  mutable bool _indexed;
+
+  void write(size_type index, bool value)
+  {
+    std::uint64_t bit = std::uint64_t(1) << (index % 64);
+    if(value) _words[index / 64] |= bit;
+    else _words[index / 64] &= ~bit;
+    _indexed = false;
+  }
+
+  void buildIndex() const
+  {
+    if(_indexed) return;
+
+    size_type blocks = (_words.getSize() + WORDS_PER_BLOCK - 1) / WORDS_PER_BLOCK;
+    _ranks.clear();
+    _ranks.reserve(blocks + 1);
+    std::uint64_t ones = 0;
+    for(size_type b = 0; b < blocks; ++b){
+        _ranks.append(ones);
+        size_type first = b * WORDS_PER_BLOCK;
+        size_type count = _words.getSize() - first < WORDS_PER_BLOCK ? _words.getSize() - first : WORDS_PER_BLOCK;
+        ones += simd::popcount(_words.data() + first, count);
+    }
+    _ranks.append(ones);
+    _indexed = true;
+  }
+
+  //bits of the given value before block b
+  template <bool One>
+  size_type before(size_type block) const
+  {
+    return One ? _ranks[block] : block * WORDS_PER_BLOCK * 64 - _ranks[block];
+  }
+
+  //binary search for the block, then a scan of its words and of the bits of one word
+  template <bool One>
+  size_type selectBit(size_type k) const
+  {
+    buildIndex();
+    size_type total = One ? _ranks[_ranks.getSize() - 1] : _size - _ranks[_ranks.getSize() - 1];
+    if(k >= total) throw std::out_of_range("Selecting beyond the last bit");
+
+    size_type low = 0, high = _ranks.getSize() - 1;
+    while(high - low > 1){
+        size_type middle = low + (high - low) / 2;
+        if(before<One>(middle) <= k) low = middle;
+        else high = middle;
+    }
+    k -= before<One>(low);
+
+    for(size_type word = low * WORDS_PER_BLOCK; ; ++word){
+        std::uint64_t bits = One ? _words[word] : ~_words[word];
+        size_type ones = simd::popcount(&bits, 1);
+        if(k < ones){
+            for(; k; --k) bits &= bits - 1;
+            return word * 64 + __builtin_ctzll(bits);
+        }
+        k -= ones;
+    }
+  }
+};
+
+//bits are read when dereferenced, there are no references to them
+class BitVector::ConstIterator
+{
+protected:
+  const BitVector *vec;
+
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = BitVector::value_type;
+  using difference_type = BitVector::difference_type;
+  using pointer = void;
+  using reference = bool;
+
+  size_t position;
+
+  ConstIterator() : vec(nullptr), position(0) {}
+
+  explicit ConstIterator(const BitVector &v, size_t pos) : vec(&v), position(pos) {}
+
+  reference operator*() const
+  {
+    if(this->position == vec->getSize()) throw std::out_of_range("Tried to get value of end() element");
+    return (*vec)[position];
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return (*vec)[position + d];
+  }
+
+  ConstIterator& operator++()
+  {
+    if(++(this->position) > vec->getSize()) throw std::out_of_range("Array exceeded");
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator tmp = *this;
+    ++(*this);
+    return tmp;
+  }
+
+  ConstIterator& operator--()
+  {
+    if(this->position == 0) throw std::out_of_range("Array exceeded");
+    this->position--;
+    return *this;
+  }
+
+  ConstIterator operator--(int)
+  {
+    ConstIterator tmp = *this;
+    --(*this);
+    return tmp;
+  }
+
+  ConstIterator& operator+=(difference_type d)
+  {
+    difference_type target = static_cast<difference_type>(this->position) + d;
+    if(target < 0 || target > static_cast<difference_type>(vec->getSize())) throw std::out_of_range("Array exceeded");
+    this->position = target;
+    return *this;
+  }
+
+  ConstIterator& operator-=(difference_type d)
+  {
+    return *this += -d;
+  }
+
+  ConstIterator operator+(difference_type d) const
+  {
+    ConstIterator tmp = *this;
+    return tmp += d;
+  }
+
+  friend ConstIterator operator+(difference_type d, const ConstIterator& it)
+  {
+    return it + d;
+  }
+
+  ConstIterator operator-(difference_type d) const
+  {
+    ConstIterator tmp = *this;
+    return tmp -= d;
+  }
+
+  difference_type operator-(const ConstIterator& other) const
+  {
+    return static_cast<difference_type>(this->position) - static_cast<difference_type>(other.position);
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return this->position == other.position;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+
+  bool operator<(const ConstIterator& other) const
+  {
+    return this->position < other.position;
+  }
+
+  bool operator>(const ConstIterator& other) const
+  {
+    return other < *this;
+  }
+
+  bool operator<=(const ConstIterator& other) const
+  {
+    return !(other < *this);
+  }
+
+  bool operator>=(const ConstIterator& other) const
+  {
+    return !(*this < other);
+  }
+};
+
+inline BitVector::const_iterator BitVector::begin() const
+{
+  return const_iterator(*this, 0);
+}
+
+inline BitVector::const_iterator BitVector::end() const
+{
+  return const_iterator(*this, _size);
+}
+
+inline BitVector::const_iterator BitVector::cbegin() const
+{
+  return begin();
+}
+
+inline BitVector::const_iterator BitVector::cend() const
+{
+  return end();
+}
+
+}
+
+#endif /* AISDI_LINEAR_BITVECTOR_H */
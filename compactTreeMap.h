@@ -0,0 +1,783 @@
+#ifndef AISDI_MAPS_COMPACTTREEMAP_H
+#define AISDI_MAPS_COMPACTTREEMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace aisdi
+{
+
+//TreeMap variant with all nodes kept in one growable arena and linked by 32-bit indices
+//the tree is red-black, the color is packed into the top bit of the parent index
+//freed slots are recycled; indices stay valid when the arena grows, so do iterators
+//for trivially copyable elements growing is a realloc (a memcpy for over-aligned ones)
+//and copying is a memcpy of the arena
+template <typename KeyType, typename ValueType>
+class CompactTreeMap
+{
+  struct Node;
+
+public:
+  using key_type = KeyType;
+  using mapped_type = ValueType;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using size_type = std::size_t;
+  using index_type = std::uint32_t;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+
+  class ConstIterator;
+  class Iterator;
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+
+  CompactTreeMap() : _nodes(nullptr), _capacity(0), _used(0), _size(0), _root(NIL), _freeHead(NIL) {}
+
+  CompactTreeMap(std::initializer_list<value_type> list) : CompactTreeMap()
+  {
+    reserve(list.size());
+    for(auto &i : list) (*this)[i.first] = i.second;
+  }
+
+  CompactTreeMap(const CompactTreeMap& other) : CompactTreeMap()
+  {
+    cloneArena(other);
+  }
+
+  CompactTreeMap(CompactTreeMap&& other) noexcept : CompactTreeMap()
+  {
+    steal(other);
+  }
+
+  ~CompactTreeMap(){ release(); }
+
+  CompactTreeMap& operator=(const CompactTreeMap& other)
+  {
+    if(&other == this) return *this;
+
+    release();
+    cloneArena(other);
+
+    return *this;
+  }
+
+  CompactTreeMap& operator=(CompactTreeMap&& other) noexcept
+  {
+    if(&other == this) return *this;
+
+    release();
+    steal(other);
+
+    return *this;
+  }
+
+  bool isEmpty() const
+  {
+    return !_size;
+  }
+
+  size_type getSize() const
+  {
+    return _size;
+  }
+
+  //number of slots the arena holds without growing
+  size_type capacity() const
+  {
+    return _capacity;
+  }
+
+  void reserve(size_type slots)
+  {
+    if(slots > MAX_NODES) throw std::length_error("CompactTreeMap can't hold that many elements");
+    if(slots > _capacity) grow(static_cast<index_type>(slots));
+  }
+
+  mapped_type& operator[](const key_type& key)
+  {
+    index_type parent = NIL, node = _root;
+    bool asLeft = false;
+    while(node != NIL){
+        parent = node;
+        if(key < keyOf(node)){
+            node = _nodes[node].left;
+            asLeft = true;
+        }
+        else if(keyOf(node) < key){
+            node = _nodes[node].right;
+            asLeft = false;
+        }
+        else return _nodes[node].value().second;
+    }
+
+    index_type newNode = allocate(key);
+    setParent(newNode, parent);
+    setRed(newNode, true);
+    if(parent == NIL) _root = newNode;
+    else if(asLeft) _nodes[parent].left = newNode;
+    else _nodes[parent].right = newNode;
+    ++_size;
+
+    insertFixup(newNode);
+    return _nodes[newNode].value().second;
+  }
+
+  const mapped_type& valueOf(const key_type& key) const
+  {
+    index_type node = lookup(key);
+    if(node == NIL) throw std::out_of_range("ValueOf didn't find the element");
+    return _nodes[node].value().second;
+  }
+
+  mapped_type& valueOf(const key_type& key)
+  {
+    index_type node = lookup(key);
+    if(node == NIL) throw std::out_of_range("ValueOf didn't find the element");
+    return _nodes[node].value().second;
+  }
+
+  const_iterator find(const key_type& key) const
+  {
+    return const_iterator(this, lookup(key));
+  }
+
+  iterator find(const key_type& key)
+  {
+    return iterator(this, lookup(key));
+  }
+
+  void remove(const key_type& key)
+  {
+    index_type node = lookup(key);
+    if(node == NIL) throw std::out_of_range("Remove didn't find the element");
+    removeNode(node);
+  }
+
+  void remove(const const_iterator& it)
+  {
+    if(it._index == NIL) throw std::out_of_range("Remove didn't find the element");
+    removeNode(it._index);
+  }
+
+  //drops all elements but keeps the arena for reuse
+  void clear()
+  {
+    destroyValues();
+    _used = 0;
+    _size = 0;
+    _root = _freeHead = NIL;
+  }
+
+  bool operator==(const CompactTreeMap& other) const
+  {
+    if(_size != other._size) return false;
+    for(const_iterator it1 = cbegin(), it2 = other.cbegin(); it1 != cend(); ++it1, ++it2)
+        if( (it1->first != it2->first) || (it1->second != it2->second) ) return false;
+    return true;
+  }
+
+  bool operator!=(const CompactTreeMap& other) const
+  {
+    return !(*this == other);
+  }
+
+  iterator begin()
+  {
+    return iterator(this, _root == NIL ? NIL : minimum(_root));
+  }
+
+  iterator end()
+  {
+    return iterator(this, NIL);
+  }
+
+  const_iterator cbegin() const
+  {
+    return const_iterator(this, _root == NIL ? NIL : minimum(_root));
+  }
+
+  const_iterator cend() const
+  {
+    return const_iterator(this, NIL);
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+
+private:
+  //the top bit of a parent index holds the color, so 31 bits are left for indices
+  static const index_type RED = index_type(1) << 31;
+  static const index_type NIL = RED - 1;
+  //a red root can't exist, so this parent word marks a slot on the free list
+  static const index_type FREE = NIL | RED;
+  static const index_type MAX_NODES = NIL;
+  static const index_type INITIAL_CAPACITY = 16;
+
+  struct Node{
+    alignas(value_type) unsigned char storage[sizeof(value_type)];
+    //a free slot keeps the next free index in 'left'
+    index_type left, right, parentAndColor;
+
+    value_type& value()
+    {
+      return *std::launder(reinterpret_cast<value_type*>(storage));
+    }
+
+    const value_type& value() const
+    {
+      return *std::launder(reinterpret_cast<const value_type*>(storage));
+    }
+  };
+
+  static const bool BITWISE = std::is_trivially_copyable<value_type>::value;
+
+  Node *_nodes;
+  index_type _capacity, _used, _size, _root, _freeHead;
+
+  const key_type& keyOf(index_type node) const
+  {
+    return _nodes[node].value().first;
+  }
+
+  index_type parentOf(index_type node) const
+  {
+    return _nodes[node].parentAndColor & ~RED;
+  }
+
+  void setParent(index_type node, index_type parent)
+  {
+    _nodes[node].parentAndColor = (_nodes[node].parentAndColor & RED) | parent;
+  }
+
+  bool isRed(index_type node) const
+  {
+    return node != NIL && (_nodes[node].parentAndColor & RED);
+  }
+
+  void setRed(index_type node, bool red)
+  {
+    if(red) _nodes[node].parentAndColor |= RED;
+    else _nodes[node].parentAndColor &= ~RED;
+  }
+
+  bool isFree(index_type node) const
+  {
+    return _nodes[node].parentAndColor == FREE;
+  }
+
+  index_type lookup(const key_type &key) const
+  {
+    index_type node = _root;
+    while(node != NIL){
+        if(key < keyOf(node)) node = _nodes[node].left;
+        else if(keyOf(node) < key) node = _nodes[node].right;
+        else return node;
+    }
+    return NIL;
+  }
+
+  index_type minimum(index_type node) const
+  {
+    while(_nodes[node].left != NIL) node = _nodes[node].left;
+    return node;
+  }
+
+  index_type maximum(index_type node) const
+  {
+    while(_nodes[node].right != NIL) node = _nodes[node].right;
+    return node;
+  }
+
+  index_type successor(index_type node) const
+  {
+    if(_nodes[node].right != NIL) return minimum(_nodes[node].right);
+    index_type parent = parentOf(node);
+    while(parent != NIL && node == _nodes[parent].right){
+        node = parent;
+        parent = parentOf(node);
+    }
+    return parent;
+  }
+
+  index_type predecessor(index_type node) const
+  {
+    if(_nodes[node].left != NIL) return maximum(_nodes[node].left);
+    index_type parent = parentOf(node);
+    while(parent != NIL && node == _nodes[parent].left){
+        node = parent;
+        parent = parentOf(node);
+    }
+    return parent;
+  }
+
+  //takes a recycled slot or the next untouched one, the value is default constructed
+  index_type allocate(const key_type &key)
+  {
+    bool recycled = _freeHead != NIL;
+    if(!recycled){
+        if(_used == MAX_NODES) throw std::length_error("CompactTreeMap can't hold that many elements");
+        if(_used == _capacity) grow(_capacity ? (_capacity > MAX_NODES / 2 ? MAX_NODES : _capacity * 2) : INITIAL_CAPACITY);
+    }
+    index_type node = recycled ? _freeHead : _used;
+
+    new (_nodes[node].storage) value_type(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple());
+    if(recycled) _freeHead = _nodes[node].left;
+    else ++_used;
+
+    _nodes[node].left = _nodes[node].right = NIL;
+    _nodes[node].parentAndColor = NIL;
+    return node;
+  }
+
+  void deallocate(index_type node)
+  {
+    _nodes[node].value().~value_type();
+    _nodes[node].left = _freeHead;
+    _nodes[node].parentAndColor = FREE;
+    _freeHead = node;
+  }
+
+  //realloc grows a bitwise arena in place when it can, but it only guarantees malloc's
+  //alignment; other arenas come from an aligned operator new
+  static const bool REALLOC = BITWISE && alignof(Node) <= alignof(std::max_align_t);
+
+  static Node* allocateNodes(index_type count)
+  {
+    if(!REALLOC) return static_cast<Node*>(::operator new(size_type(count) * sizeof(Node), std::align_val_t(alignof(Node))));
+    void *nodes = std::malloc(size_type(count) * sizeof(Node));
+    if(nodes == nullptr) throw std::bad_alloc();
+    return static_cast<Node*>(nodes);
+  }
+
+  static void freeNodes(Node *nodes)
+  {
+    if(REALLOC) std::free(nodes);
+    else if(nodes != nullptr) ::operator delete(nodes, std::align_val_t(alignof(Node)));
+  }
+
+  void grow(index_type newCapacity)
+  {
+    if(REALLOC){
+        void *resized = std::realloc(_nodes, size_type(newCapacity) * sizeof(Node));
+        if(resized == nullptr) throw std::bad_alloc();
+        _nodes = static_cast<Node*>(resized);
+        _capacity = newCapacity;
+        return;
+    }
+
+    Node *resized = allocateNodes(newCapacity);
+    if(BITWISE){
+        if(_used) std::memcpy(static_cast<void*>(resized), _nodes, size_type(_used) * sizeof(Node));
+    }
+    else{
+        //values are copied when moving them could throw, so a failure leaves the arena as it was
+        index_type i = 0;
+        try{
+            for(; i < _used; ++i){
+                resized[i].left = _nodes[i].left;
+                resized[i].right = _nodes[i].right;
+                resized[i].parentAndColor = _nodes[i].parentAndColor;
+                if(isFree(i)) continue;
+                new (resized[i].storage) value_type(std::move_if_noexcept(_nodes[i].value()));
+            }
+        }
+        catch(...){
+            for(index_type j = 0; j < i; ++j)
+                if(!isFree(j)) resized[j].value().~value_type();
+            freeNodes(resized);
+            throw;
+        }
+        destroyValues();
+    }
+    freeNodes(_nodes);
+    _nodes = resized;
+    _capacity = newCapacity;
+  }
+
+  void destroyValues()
+  {
+    if(BITWISE) return;
+    for(index_type i = 0; i < _used; ++i)
+        if(!isFree(i)) _nodes[i].value().~value_type();
+  }
+
+  void release()
+  {
+    destroyValues();
+    freeNodes(_nodes);
+    _nodes = nullptr;
+    _capacity = _used = _size = 0;
+    _root = _freeHead = NIL;
+  }
+
+  //the copy keeps the other map's layout slot for slot, so no index has to be rewritten
+  void cloneArena(const CompactTreeMap &other)
+  {
+    if(other._used == 0) return;
+
+    _nodes = allocateNodes(other._used);
+
+    if(BITWISE) std::memcpy(static_cast<void*>(_nodes), other._nodes, size_type(other._used) * sizeof(Node));
+    else{
+        for(index_type i = 0; i < other._used; ++i){
+            _nodes[i].left = other._nodes[i].left;
+            _nodes[i].right = other._nodes[i].right;
+            _nodes[i].parentAndColor = other._nodes[i].parentAndColor;
+            if(other.isFree(i)) continue;
+            try{
+                new (_nodes[i].storage) value_type(other._nodes[i].value());
+            }
+            catch(...){
+                //marking the rest as free lets release() skip them
+                for(index_type j = i; j < other._used; ++j) _nodes[j].parentAndColor = FREE;
+                _used = other._used;
+                release();
+                throw;
+            }
+        }
+    }
+
+    _capacity = _used = other._used;
+    _size = other._size;
+    _root = other._root;
+    _freeHead = other._freeHead;
+  }
+
+  void steal(CompactTreeMap &other)
+  {
+    _nodes = other._nodes;
+    _capacity = other._capacity;
+    _used = other._used;
+    _size = other._size;
+    _root = other._root;
+    _freeHead = other._freeHead;
+
+    other._nodes = nullptr;
+    other._capacity = other._used = other._size = 0;
+    other._root = other._freeHead = NIL;
+  }
+
+  void rotateLeft(index_type node)
+  {
+    index_type child = _nodes[node].right, parent = parentOf(node);
+    _nodes[node].right = _nodes[child].left;
+    if(_nodes[child].left != NIL) setParent(_nodes[child].left, node);
+    setParent(child, parent);
+    if(parent == NIL) _root = child;
+    else if(_nodes[parent].left == node) _nodes[parent].left = child;
+    else _nodes[parent].right = child;
+    _nodes[child].left = node;
+    setParent(node, child);
+  }
+
+  void rotateRight(index_type node)
+  {
+    index_type child = _nodes[node].left, parent = parentOf(node);
+    _nodes[node].left = _nodes[child].right;
+    if(_nodes[child].right != NIL) setParent(_nodes[child].right, node);
+    setParent(child, parent);
+    if(parent == NIL) _root = child;
+    else if(_nodes[parent].right == node) _nodes[parent].right = child;
+    else _nodes[parent].left = child;
+    _nodes[child].right = node;
+    setParent(node, child);
+  }
+
+  void insertFixup(index_type node)
+  {
+    while(node != _root && isRed(parentOf(node))){
+        index_type parent = parentOf(node), grandparent = parentOf(parent);
+        if(parent == _nodes[grandparent].left){
+            index_type uncle = _nodes[grandparent].right;
+            if(isRed(uncle)){
+                setRed(parent, false);
+                setRed(uncle, false);
+                setRed(grandparent, true);
+                node = grandparent;
+                continue;
+            }
+            if(node == _nodes[parent].right){
+                node = parent;
+                rotateLeft(node);
+                parent = parentOf(node);
+            }
+            setRed(parent, false);
+            setRed(grandparent, true);
+            rotateRight(grandparent);
+        }
+        else{
+            index_type uncle = _nodes[grandparent].left;
+            if(isRed(uncle)){
+                setRed(parent, false);
+                setRed(uncle, false);
+                setRed(grandparent, true);
+                node = grandparent;
+                continue;
+            }
+            if(node == _nodes[parent].left){
+                node = parent;
+                rotateRight(node);
+                parent = parentOf(node);
+            }
+            setRed(parent, false);
+            setRed(grandparent, true);
+            rotateLeft(grandparent);
+        }
+    }
+    setRed(_root, false);
+  }
+
+  //puts 'replacement' (possibly NIL) in the place of 'node'
+  void transplant(index_type node, index_type replacement)
+  {
+    index_type parent = parentOf(node);
+    if(parent == NIL) _root = replacement;
+    else if(node == _nodes[parent].left) _nodes[parent].left = replacement;
+    else _nodes[parent].right = replacement;
+    if(replacement != NIL) setParent(replacement, parent);
+  }
+
+  void removeNode(index_type node)
+  {
+    index_type child, childParent;
+    bool removedRed = isRed(node);
+
+    if(_nodes[node].left == NIL){
+        child = _nodes[node].right;
+        childParent = parentOf(node);
+        transplant(node, child);
+    }
+    else if(_nodes[node].right == NIL){
+        child = _nodes[node].left;
+        childParent = parentOf(node);
+        transplant(node, child);
+    }
+    else{
+        //the successor takes over the node's place and color
+        index_type next = minimum(_nodes[node].right);
+        removedRed = isRed(next);
+        child = _nodes[next].right;
+        if(parentOf(next) == node) childParent = next;
+        else{
+            childParent = parentOf(next);
+            transplant(next, child);
+            _nodes[next].right = _nodes[node].right;
+            setParent(_nodes[next].right, next);
+        }
+        transplant(node, next);
+        _nodes[next].left = _nodes[node].left;
+        setParent(_nodes[next].left, next);
+        setRed(next, isRed(node));
+    }
+
+    deallocate(node);
+    --_size;
+    if(!removedRed) removeFixup(child, childParent);
+  }
+
+  void removeFixup(index_type node, index_type parent)
+  {
+    while(node != _root && !isRed(node)){
+        if(node == _nodes[parent].left){
+            index_type sibling = _nodes[parent].right;
+            if(isRed(sibling)){
+                setRed(sibling, false);
+                setRed(parent, true);
+                rotateLeft(parent);
+                sibling = _nodes[parent].right;
+            }
+            if(!isRed(_nodes[sibling].left) && !isRed(_nodes[sibling].right)){
+                setRed(sibling, true);
+                node = parent;
+                parent = parentOf(node);
+                continue;
+            }
+            if(!isRed(_nodes[sibling].right)){
+                setRed(_nodes[sibling].left, false);
+                setRed(sibling, true);
+                rotateRight(sibling);
+                sibling = _nodes[parent].right;
+            }
+            setRed(sibling, isRed(parent));
+            setRed(parent, false);
+            setRed(_nodes[sibling].right, false);
+            rotateLeft(parent);
+        }
+        else{
+            index_type sibling = _nodes[parent].left;
+            if(isRed(sibling)){
+                setRed(sibling, false);
+                setRed(parent, true);
+                rotateRight(parent);
+                sibling = _nodes[parent].left;
+            }
+            if(!isRed(_nodes[sibling].left) && !isRed(_nodes[sibling].right)){
+                setRed(sibling, true);
+                node = parent;
+                parent = parentOf(node);
+                continue;
+            }
+            if(!isRed(_nodes[sibling].left)){
+                setRed(_nodes[sibling].right, false);
+                setRed(sibling, true);
+                rotateLeft(sibling);
+                sibling = _nodes[parent].left;
+            }
+            setRed(sibling, isRed(parent));
+            setRed(parent, false);
+            setRed(_nodes[sibling].left, false);
+            rotateRight(parent);
+        }
+        node = _root;
+    }
+    if(node != NIL) setRed(node, false);
+  }
+};
+
+template <typename KeyType, typename ValueType>
+class CompactTreeMap<KeyType, ValueType>::ConstIterator
+{
+public:
+  using reference = typename CompactTreeMap::const_reference;
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = typename CompactTreeMap::value_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const typename CompactTreeMap::value_type*;
+
+  explicit ConstIterator(const CompactTreeMap *map = nullptr, index_type index = CompactTreeMap::NIL) : _map(map), _index(index) {}
+
+  ConstIterator& operator++()
+  {
+    if(_index == CompactTreeMap::NIL) throw std::out_of_range("Tried to iterate beyond the tree");
+    _index = _map->successor(_index);
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator result = *this;
+    ++(*this);
+    return result;
+  }
+
+  ConstIterator& operator--()
+  {
+    if(_index == CompactTreeMap::NIL){
+        if(_map == nullptr || _map->_root == CompactTreeMap::NIL) throw std::out_of_range("Tried to iterate beyond the tree");
+        _index = _map->maximum(_map->_root);
+        return *this;
+    }
+
+    index_type previous = _map->predecessor(_index);
+    if(previous == CompactTreeMap::NIL) throw std::out_of_range("Tried to iterate beyond the tree");
+    _index = previous;
+    return *this;
+  }
+
+  ConstIterator operator--(int)
+  {
+    ConstIterator result = *this;
+    --(*this);
+    return result;
+  }
+
+  reference operator*() const
+  {
+    if(_index == CompactTreeMap::NIL) throw std::out_of_range("Tried to get the value of the end()");
+    return _map->_nodes[_index].value();
+  }
+
+  pointer operator->() const
+  {
+    return &this->operator*();
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return _index == other._index;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+
+protected:
+  friend class CompactTreeMap;
+
+  const CompactTreeMap *_map;
+  index_type _index;
+};
+
+template <typename KeyType, typename ValueType>
+class CompactTreeMap<KeyType, ValueType>::Iterator : public CompactTreeMap<KeyType, ValueType>::ConstIterator
+{
+public:
+  using reference = typename CompactTreeMap::reference;
+  using pointer = typename CompactTreeMap::value_type*;
+
+  explicit Iterator() : ConstIterator()
+  {}
+
+  Iterator(const ConstIterator& other)
+    : ConstIterator(other)
+  {}
+
+  Iterator(CompactTreeMap *map, index_type index) : ConstIterator(map, index) {}
+
+  Iterator& operator++()
+  {
+    ConstIterator::operator++();
+    return *this;
+  }
+
+  Iterator operator++(int)
+  {
+    auto result = *this;
+    ConstIterator::operator++();
+    return result;
+  }
+
+  Iterator& operator--()
+  {
+    ConstIterator::operator--();
+    return *this;
+  }
+
+  Iterator operator--(int)
+  {
+    auto result = *this;
+    ConstIterator::operator--();
+    return result;
+  }
+
+  pointer operator->() const
+  {
+    return &this->operator*();
+  }
+
+  reference operator*() const
+  {
+    // ugly cast, yet reduces code duplication.
+    return const_cast<reference>(ConstIterator::operator*());
+  }
+};
+
+}
+
+#endif /* AISDI_MAPS_COMPACTTREEMAP_H */
@@ -0,0 +1,449 @@
+#ifndef AISDI_MAPS_CONCURRENTSKIPLISTMAP_H
+#define AISDI_MAPS_CONCURRENTSKIPLISTMAP_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "epochDomain.h"
+
+namespace aisdi
+{
+
+//ordered map safe to use from many threads at once
+//lookups never block, inserts and removes are lock-free (CAS on marked next pointers),
+//unlinked nodes are reclaimed through the EpochDomain
+//iteration is weakly consistent: it sees every element present during the whole traversal
+//and may or may not see elements inserted or removed meanwhile
+template <typename KeyType, typename ValueType>
+class ConcurrentSkipListMap
+{
+  struct Node;
+
+public:
+  using key_type = KeyType;
+  using mapped_type = ValueType;
+  //iterators hand out snapshots since values may be replaced concurrently
+  using value_type = std::pair<key_type, mapped_type>;
+  using size_type = std::size_t;
+  using reference = const value_type&;
+  using const_reference = const value_type&;
+
+  class ConstIterator;
+  using iterator = ConstIterator;
+  using const_iterator = ConstIterator;
+
+  ConcurrentSkipListMap() : _size(0)
+  {
+    for(int i = 0; i < MAX_LEVEL; ++i) _head[i].store(0, std::memory_order_relaxed);
+  }
+
+  ConcurrentSkipListMap(std::initializer_list<std::pair<const key_type, mapped_type>> list) : ConcurrentSkipListMap()
+  {
+    for(auto &i : list) insertOrAssign(i.first, i.second);
+  }
+
+  ConcurrentSkipListMap(const ConcurrentSkipListMap&) = delete;
+  ConcurrentSkipListMap& operator=(const ConcurrentSkipListMap&) = delete;
+
+  //no other thread may use the map while it is destroyed
+  ~ConcurrentSkipListMap()
+  {
+    Node *node = pointerOf(_head[0].load());
+    while(node != nullptr){
+        Node *next = pointerOf(node->tower()[0].load());
+        Node::destroy(node);
+        node = next;
+    }
+  }
+
+  bool isEmpty() const
+  {
+    return begin() == end();
+  }
+
+  //exact when the map is quiescent, otherwise an approximation
+  size_type getSize() const
+  {
+    std::ptrdiff_t size = _size.load(std::memory_order_relaxed);
+    return size < 0 ? 0 : size;
+  }
+
+  //inserts the element if the key is absent, returns false if it was already present
+  bool insert(const key_type& key, const mapped_type& value)
+  {
+    return upsert(key, value, false);
+  }
+
+  //operator[]-style upsert, returns true if a new element was created
+  bool insertOrAssign(const key_type& key, const mapped_type& value)
+  {
+    return upsert(key, value, true);
+  }
+
+  mapped_type valueOf(const key_type& key) const
+  {
+    EpochDomain::Guard guard;
+    Node *node = searchNotLess(key);
+    if(node == nullptr || key < node->key) throw std::out_of_range("ValueOf didn't find the element");
+    return *node->value.load(std::memory_order_acquire);
+  }
+
+  bool contains(const key_type& key) const
+  {
+    EpochDomain::Guard guard;
+    Node *node = searchNotLess(key);
+    return node != nullptr && !(key < node->key);
+  }
+
+  const_iterator find(const key_type& key) const
+  {
+    EpochDomain::Guard guard;
+    Node *node = searchNotLess(key);
+    if(node == nullptr || key < node->key) return cend();
+    return const_iterator(node);
+  }
+
+  //first element whose key is not less than the given one
+  const_iterator lowerBound(const key_type& key) const
+  {
+    EpochDomain::Guard guard;
+    return const_iterator(searchNotLess(key));
+  }
+
+  //returns false if there was no element with the given key
+  bool remove(const key_type& key)
+  {
+    EpochDomain::Guard guard;
+    std::atomic<std::uintptr_t> *preds[MAX_LEVEL];
+    Node *succs[MAX_LEVEL];
+
+    while(true){
+        if(!findPosition(key, preds, succs, false)) return false;
+        Node *victim = succs[0];
+
+        //marking the upper levels first so that nobody links the node there anymore
+        for(int level = victim->topLevel - 1; level > 0; --level){
+            std::uintptr_t next = victim->tower()[level].load();
+            while(!isMarked(next) && !victim->tower()[level].compare_exchange_weak(next, next | MARK));
+        }
+
+        //the thread marking the bottom level owns the removal
+        std::uintptr_t next = victim->tower()[0].load();
+        while(!isMarked(next)){
+            if(victim->tower()[0].compare_exchange_weak(next, next | MARK)){
+                _size.fetch_sub(1, std::memory_order_relaxed);
+                findPosition(key, preds, succs, false);
+                release(victim);
+                return true;
+            }
+        }
+        //somebody else removed it first, there may be a newer element with the same key
+    }
+  }
+
+  const_iterator cbegin() const
+  {
+    EpochDomain::Guard guard;
+    return const_iterator(firstAlive(pointerOf(_head[0].load(std::memory_order_acquire))));
+  }
+
+  const_iterator cend() const
+  {
+    return const_iterator(nullptr);
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+
+private:
+  static const int MAX_LEVEL = 24;
+  //the lowest bit of a next pointer marks its owner as removed on that level
+  static const std::uintptr_t MARK = 1;
+
+  struct Node{
+    const key_type key;
+    std::atomic<mapped_type*> value;
+    //one reference held by the inserter until it stops linking upper levels,
+    //one by the remover, whoever drops the last one unlinks the node for good
+    std::atomic<int> references;
+    const int topLevel;
+
+    Node(const key_type &k, mapped_type *v, int level) : key(k), value(v), references(2), topLevel(level) {}
+
+    //next pointers are stored right behind the node, one per level
+    std::atomic<std::uintptr_t>* tower()
+    {
+      return reinterpret_cast<std::atomic<std::uintptr_t>*>(this + 1);
+    }
+
+    static Node* create(const key_type &key, const mapped_type &value, int level)
+    {
+      void *raw = ::operator new(sizeof(Node) + level * sizeof(std::atomic<std::uintptr_t>));
+      mapped_type *v = nullptr;
+      try{
+          v = new mapped_type(value);
+          Node *node = new (raw) Node(key, v, level);
+          for(int i = 0; i < level; ++i) new (&node->tower()[i]) std::atomic<std::uintptr_t>(0);
+          return node;
+      }
+      catch(...){
+          delete v;
+          ::operator delete(raw);
+          throw;
+      }
+    }
+
+    static void destroy(void *object)
+    {
+      Node *node = static_cast<Node*>(object);
+      delete node->value.load(std::memory_order_relaxed);
+      node->~Node();
+      ::operator delete(object);
+    }
+  };
+
+  std::atomic<std::uintptr_t> _head[MAX_LEVEL];
+  std::atomic<std::ptrdiff_t> _size;
+
+  static Node* pointerOf(std::uintptr_t word)
+  {
+    return reinterpret_cast<Node*>(word & ~MARK);
+  }
+
+  static std::uintptr_t wordOf(Node *node)
+  {
+    return reinterpret_cast<std::uintptr_t>(node);
+  }
+
+  static bool isMarked(std::uintptr_t word)
+  {
+    return word & MARK;
+  }
+
+  static void deleteValue(void *value)
+  {
+    delete static_cast<mapped_type*>(value);
+  }
+
+  //geometric distribution with p = 1/2
+  static int randomLevel()
+  {
+    static thread_local std::uint64_t seed = 0x9E3779B97F4A7C15ull ^ reinterpret_cast<std::uintptr_t>(&seed);
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    int level = 1;
+    for(std::uint64_t bits = seed; (bits & 1) && level < MAX_LEVEL; bits >>= 1) ++level;
+    return level;
+  }
+
+  //fills preds (next pointers to swing) and succs on every level for the given key,
+  //physically unlinking marked nodes on the way
+  //with passEqual set it also walks over nodes equal to key so that no marked copy of it survives
+  //returns true if an unmarked node with the key was found
+  bool findPosition(const key_type &key, std::atomic<std::uintptr_t> **preds, Node **succs, bool passEqual)
+  {
+retry:
+    std::atomic<std::uintptr_t> *predTower = _head;
+    for(int level = MAX_LEVEL - 1; level >= 0; --level){
+        Node *curr = pointerOf(predTower[level].load(std::memory_order_acquire));
+        while(curr != nullptr){
+            std::uintptr_t succ = curr->tower()[level].load(std::memory_order_acquire);
+            if(isMarked(succ)){
+                std::uintptr_t expected = wordOf(curr);
+                if(!predTower[level].compare_exchange_strong(expected, succ & ~MARK)) goto retry;
+                curr = pointerOf(succ);
+                continue;
+            }
+            if(!(curr->key < key)) break;
+            predTower = curr->tower();
+            curr = pointerOf(succ);
+        }
+        preds[level] = &predTower[level];
+        succs[level] = curr;
+
+        if(passEqual){
+            std::atomic<std::uintptr_t> *cursor = predTower;
+            while(curr != nullptr && !(key < curr->key)){
+                std::uintptr_t succ = curr->tower()[level].load(std::memory_order_acquire);
+                if(isMarked(succ)){
+                    std::uintptr_t expected = wordOf(curr);
+                    if(!cursor[level].compare_exchange_strong(expected, succ & ~MARK)) goto retry;
+                }
+                else cursor = curr->tower();
+                curr = pointerOf(succ);
+            }
+        }
+    }
+    return succs[0] != nullptr && !(key < succs[0]->key);
+  }
+
+  //read-only descent, skips marked nodes without unlinking them
+  Node* searchNotLess(const key_type &key) const
+  {
+    const std::atomic<std::uintptr_t> *predTower = _head;
+    Node *curr = nullptr;
+    for(int level = MAX_LEVEL - 1; level >= 0; --level){
+        curr = pointerOf(predTower[level].load(std::memory_order_acquire));
+        while(curr != nullptr){
+            std::uintptr_t succ = curr->tower()[level].load(std::memory_order_acquire);
+            if(isMarked(succ)) curr = pointerOf(succ);
+            else if(curr->key < key){
+                predTower = curr->tower();
+                curr = pointerOf(succ);
+            }
+            else break;
+        }
+    }
+    return curr;
+  }
+
+  static Node* firstAlive(Node *node)
+  {
+    while(node != nullptr){
+        std::uintptr_t next = node->tower()[0].load(std::memory_order_acquire);
+        if(!isMarked(next)) return node;
+        node = pointerOf(next);
+    }
+    return nullptr;
+  }
+
+  bool upsert(const key_type &key, const mapped_type &value, bool assign)
+  {
+    EpochDomain::Guard guard;
+    std::atomic<std::uintptr_t> *preds[MAX_LEVEL];
+    Node *succs[MAX_LEVEL];
+    Node *node = nullptr;
+
+    while(true){
+        if(findPosition(key, preds, succs, false)){
+            if(node != nullptr) Node::destroy(node);
+            if(assign){
+                mapped_type *old = succs[0]->value.exchange(new mapped_type(value), std::memory_order_acq_rel);
+                EpochDomain::instance().retire(old, &deleteValue);
+            }
+            return false;
+        }
+
+        if(node == nullptr) node = Node::create(key, value, randomLevel());
+        for(int level = 0; level < node->topLevel; ++level)
+            node->tower()[level].store(wordOf(succs[level]), std::memory_order_relaxed);
+
+        std::uintptr_t expected = wordOf(succs[0]);
+        if(preds[0]->compare_exchange_strong(expected, wordOf(node), std::memory_order_release)) break;
+    }
+    _size.fetch_add(1, std::memory_order_relaxed);
+
+    //the element is in the map now, upper levels only speed up searching
+    for(int level = 1; level < node->topLevel; ++level){
+        while(true){
+            std::uintptr_t next = node->tower()[level].load();
+            if(isMarked(next)) goto linked;
+            if(pointerOf(next) != succs[level] && !node->tower()[level].compare_exchange_strong(next, wordOf(succs[level])))
+                goto linked;
+
+            std::uintptr_t expected = wordOf(succs[level]);
+            if(preds[level]->compare_exchange_strong(expected, wordOf(node))) break;
+
+            findPosition(key, preds, succs, false);
+            if(succs[0] != node) goto linked;
+        }
+    }
+linked:
+    release(node);
+    return true;
+  }
+
+  void release(Node *node)
+  {
+    if(node->references.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+    //nobody links the node anymore, a last sweep makes it unreachable on every level
+    std::atomic<std::uintptr_t> *preds[MAX_LEVEL];
+    Node *succs[MAX_LEVEL];
+    findPosition(node->key, preds, succs, true);
+    EpochDomain::instance().retire(node, &Node::destroy);
+  }
+};
+
+template <typename KeyType, typename ValueType>
+class ConcurrentSkipListMap<KeyType, ValueType>::ConstIterator
+{
+public:
+  using reference = typename ConcurrentSkipListMap::const_reference;
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = typename ConcurrentSkipListMap::value_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const typename ConcurrentSkipListMap::value_type*;
+
+  //an iterator keeps its thread pinned in the current epoch, it must not outlive
+  //the map nor be handed over to another thread
+  explicit ConstIterator(Node *node = nullptr) : _node(node)
+  {
+    takeSnapshot();
+  }
+
+  ConstIterator& operator++()
+  {
+    if(_node == nullptr) throw std::out_of_range("Tried to iterate beyond the map");
+    _node = ConcurrentSkipListMap::firstAlive(ConcurrentSkipListMap::pointerOf(_node->tower()[0].load(std::memory_order_acquire)));
+    takeSnapshot();
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator result = *this;
+    ++(*this);
+    return result;
+  }
+
+  reference operator*() const
+  {
+    if(_node == nullptr) throw std::out_of_range("Tried to get the value of the end()");
+    return *_snapshot;
+  }
+
+  pointer operator->() const
+  {
+    return &this->operator*();
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return _node == other._node;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+
+private:
+  EpochDomain::Guard _guard;
+  Node *_node;
+  std::optional<value_type> _snapshot;
+
+  void takeSnapshot()
+  {
+    if(_node == nullptr) _snapshot.reset();
+    else _snapshot.emplace(_node->key, *_node->value.load(std::memory_order_acquire));
+  }
+};
+
+}
+
+#endif /* AISDI_MAPS_CONCURRENTSKIPLISTMAP_H */
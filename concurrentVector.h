@@ -0,0 +1,402 @@
+#ifndef AISDI_CONCURRENT_CONCURRENTVECTOR_H
+#define AISDI_CONCURRENT_CONCURRENTVECTOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace aisdi
+{
+
+//append-only vector safe to fill from many threads at once
+//an append claims its index with a fetch-add and constructs the element in a block
+//that never moves: block k holds FirstBlock << k elements and is allocated by the first
+//thread needing it, so appends are lock-free and readers are never disturbed by growth
+//an element is published once it and every element before it are constructed;
+//getSize() is that watermark and elements below it may be read from any thread
+//running out of memory while allocating a block leaves the claimed index unpublished,
+//which stops the watermark for good
+template <typename Type, std::size_t FirstBlock = 64>
+class ConcurrentVector
+{
+  static_assert(FirstBlock > 0 && (FirstBlock & (FirstBlock - 1)) == 0, "FirstBlock has to be a power of two");
+  //a claimed slot must be filled, so elements are built aside when that may throw and moved in
+  static_assert(std::is_nothrow_move_constructible<Type>::value, "ConcurrentVector needs a noexcept move constructor");
+
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = Type;
+  using pointer = Type*;
+  using reference = Type&;
+  using const_pointer = const Type*;
+  using const_reference = const Type&;
+
+  class ConstIterator;
+  using iterator = ConstIterator;
+  using const_iterator = ConstIterator;
+
+  ConcurrentVector() : _claimed(0), _published(0)
+  {
+    for(size_type i = 0; i < MAX_BLOCKS; ++i) _blocks[i].store(nullptr, std::memory_order_relaxed);
+  }
+
+  ConcurrentVector(const ConcurrentVector&) = delete;
+  ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+  //no other thread may use the vector while it is destroyed
+  ~ConcurrentVector()
+  {
+    clear();
+    for(size_type i = 0; i < MAX_BLOCKS; ++i){
+        pointer block = _blocks[i].load();
+        if(block != nullptr) freeBlock(block, i);
+    }
+  }
+
+  //index must be below getSize()
+  const Type& operator[](size_type index) const
+  {
+    size_type block = blockOf(index);
+    return _blocks[block].load(std::memory_order_acquire)[index - blockStart(block)];
+  }
+
+  //writes to an element race with every other access to it
+  Type& operator[](size_type index)
+  {
+    size_type block = blockOf(index);
+    return _blocks[block].load(std::memory_order_acquire)[index - blockStart(block)];
+  }
+
+  const Type& at(size_type index) const
+  {
+    if(index >= getSize()) throw std::out_of_range("Index beyond the published elements");
+    return (*this)[index];
+  }
+
+  bool isEmpty() const
+  {
+    return getSize() == 0;
+  }
+
+  //published elements, all of [0, getSize()) may be read
+  size_type getSize() const
+  {
+    return _published.load();
+  }
+
+  //claimed indices, including elements still under construction
+  size_type getClaimed() const
+  {
+    return _claimed.load();
+  }
+
+  //allocates the blocks needed to hold 'count' elements, so appends up to it never allocate
+  void reserve(size_type count)
+  {
+    for(size_type block = 0; blockStart(block) < count; ++block) blockFor(block);
+  }
+
+  //returns the index of the element
+  size_type append(const Type& item)
+  {
+    return emplaceBack(item);
+  }
+
+  size_type append(Type&& item)
+  {
+    return emplaceBack(std::move(item));
+  }
+
+  template <typename... Args>
+  size_type emplaceBack(Args&&... args)
+  {
+    if constexpr(std::is_nothrow_constructible<Type, Args&&...>::value){
+        size_type index = _claimed.fetch_add(1);
+        new (slot(index)) Type(std::forward<Args>(args)...);
+        publish(index);
+        prepareNext(index);
+        return index;
+    }
+    else{
+        Type item(std::forward<Args>(args)...);
+        size_type index = _claimed.fetch_add(1);
+        new (slot(index)) Type(std::move(item));
+        publish(index);
+        prepareNext(index);
+        return index;
+    }
+  }
+
+  //drops the elements, the blocks are kept; no other thread may use the vector meanwhile
+  void clear()
+  {
+    size_type claimed = _claimed.load();
+    for(size_type i = 0; i < claimed; ++i){
+        if(!isReady(i)) continue;
+        (*this)[i].~Type();
+        readyFlag(i).store(false);
+    }
+    _claimed.store(0);
+    _published.store(0);
+  }
+
+  iterator begin() const
+  {
+    return iterator(*this, 0);
+  }
+
+  //the end of the elements published by the time of the call
+  iterator end() const
+  {
+    return iterator(*this, getSize());
+  }
+
+  const_iterator cbegin() const
+  {
+    return begin();
+  }
+
+  const_iterator cend() const
+  {
+    return end();
+  }
+
+private:
+  static constexpr size_type FIRST_SHIFT = __builtin_ctzll(FirstBlock);
+  //enough blocks to address every size_type index
+  static constexpr size_type MAX_BLOCKS = sizeof(size_type) * 8 - FIRST_SHIFT;
+  static constexpr size_type CACHE_LINE = 64;
+
+  //every block is followed by the ready flags of its elements
+  std::atomic<pointer> _blocks[MAX_BLOCKS];
+  //the two counters are hammered by different threads, so they get lines of their own
+  alignas(CACHE_LINE) std::atomic<size_type> _claimed;
+  alignas(CACHE_LINE) std::atomic<size_type> _published;
+
+  static size_type blockOf(size_type index)
+  {
+    return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(index + FirstBlock) - FIRST_SHIFT;
+  }
+
+  static size_type blockStart(size_type block)
+  {
+    return (FirstBlock << block) - FirstBlock;
+  }
+
+  static std::atomic<bool>* flagsOf(pointer block, size_type blockIndex)
+  {
+    return reinterpret_cast<std::atomic<bool>*>(block + (FirstBlock << blockIndex));
+  }
+
+  static void freeBlock(pointer block, size_type blockIndex)
+  {
+    size_type count = FirstBlock << blockIndex;
+    std::atomic<bool> *flags = flagsOf(block, blockIndex);
+    for(size_type i = 0; i < count; ++i) flags[i].~atomic();
+    if(alignof(Type) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) ::operator delete(block, std::align_val_t(alignof(Type)));
+    else ::operator delete(block);
+  }
+
+  //the block, allocated if no thread did it yet; a thread losing the race frees its copy
+  pointer blockFor(size_type blockIndex)
+  {
+    if(blockIndex >= MAX_BLOCKS) throw std::length_error("ConcurrentVector is full");
+    pointer block = _blocks[blockIndex].load(std::memory_order_acquire);
+    if(block != nullptr) return block;
+
+    size_type count = FirstBlock << blockIndex;
+    size_type bytes = count * sizeof(Type) + count * sizeof(std::atomic<bool>);
+    pointer fresh;
+    if(alignof(Type) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        fresh = static_cast<pointer>(::operator new(bytes, std::align_val_t(alignof(Type))));
+    else fresh = static_cast<pointer>(::operator new(bytes));
+    std::atomic<bool> *flags = flagsOf(fresh, blockIndex);
+    for(size_type i = 0; i < count; ++i) new (flags + i) std::atomic<bool>(false);
+
+    if(_blocks[blockIndex].compare_exchange_strong(block, fresh)) return fresh;
+    freeBlock(fresh, blockIndex);
+    return block;
+  }
+
+  pointer slot(size_type index)
+  {
+    size_type block = blockOf(index);
+    return blockFor(block) + (index - blockStart(block));
+  }
+
+  //the thread filling the first slot of a block allocates the next one, so that appends
+  //seldom wait on an allocation; its element is published already, so a failure is left
+  //to the append that really needs the block
+  void prepareNext(size_type index)
+  {
+    size_type block = blockOf(index);
+    if(index != blockStart(block) || block + 1 >= MAX_BLOCKS) return;
+    try{
+        blockFor(block + 1);
+    }
+    catch(const std::bad_alloc&){}
+  }
+
+  std::atomic<bool>& readyFlag(size_type index) const
+  {
+    size_type block = blockOf(index);
+    return flagsOf(_blocks[block].load(), block)[index - blockStart(block)];
+  }
+
+  bool isReady(size_type index) const
+  {
+    size_type block = blockOf(index);
+    pointer data = _blocks[block].load();
+    return data != nullptr && flagsOf(data, block)[index - blockStart(block)].load();
+  }
+
+  //marks the element constructed and moves the watermark over every ready element;
+  //the thread whose element closes a gap carries the watermark past the ones behind it,
+  //and both the flag store and the watermark update are sequentially consistent so that
+  //a thread stopping at a not yet ready element can't miss its owner finishing
+  void publish(size_type index)
+  {
+    readyFlag(index).store(true);
+    size_type published = _published.load();
+    while(published < _claimed.load() && isReady(published)){
+        if(_published.compare_exchange_weak(published, published + 1)) ++published;
+    }
+  }
+};
+
+template <typename Type, std::size_t FirstBlock>
+class ConcurrentVector<Type, FirstBlock>::ConstIterator
+{
+protected:
+  const ConcurrentVector *vec;
+
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename ConcurrentVector::value_type;
+  using difference_type = typename ConcurrentVector::difference_type;
+  using pointer = typename ConcurrentVector::const_pointer;
+  using reference = typename ConcurrentVector::const_reference;
+
+  size_t position;
+
+  ConstIterator() : vec(nullptr), position(0) {}
+
+  explicit ConstIterator(const ConcurrentVector &v, size_t pos) : vec(&v), position(pos) {}
+
+  reference operator*() const
+  {
+    if(this->position >= vec->getSize()) throw std::out_of_range("Tried to get value of end() element");
+    return (*vec)[position];
+  }
+
+  pointer operator->() const
+  {
+    return &this->operator*();
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return (*vec)[position + d];
+  }
+
+  ConstIterator& operator++()
+  {
+    if(++(this->position) > vec->getSize()) throw std::out_of_range("Array exceeded");
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator tmp = *this;
+    ++(*this);
+    return tmp;
+  }
+
+  ConstIterator& operator--()
+  {
+    if(this->position == 0) throw std::out_of_range("Array exceeded");
+    this->position--;
+    return *this;
+  }
+
+  ConstIterator operator--(int)
+  {
+    ConstIterator tmp = *this;
+    --(*this);
+    return tmp;
+  }
+
+  ConstIterator& operator+=(difference_type d)
+  {
+    difference_type target = static_cast<difference_type>(this->position) + d;
+    if(target < 0 || target > static_cast<difference_type>(vec->getSize())) throw std::out_of_range("Array exceeded");
+    this->position = target;
+    return *this;
+  }
+
+  ConstIterator& operator-=(difference_type d)
+  {
+    return *this += -d;
+  }
+
+  ConstIterator operator+(difference_type d) const
+  {
+    ConstIterator tmp = *this;
+    return tmp += d;
+  }
+
+  friend ConstIterator operator+(difference_type d, const ConstIterator& it)
+  {
+    return it + d;
+  }
+
+  ConstIterator operator-(difference_type d) const
+  {
+    ConstIterator tmp = *this;
+    return tmp -= d;
+  }
+
+  difference_type operator-(const ConstIterator& other) const
+  {
+    return static_cast<difference_type>(this->position) - static_cast<difference_type>(other.position);
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return this->position == other.position;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+
+  bool operator<(const ConstIterator& other) const
+  {
+    return this->position < other.position;
+  }
+
+  bool operator>(const ConstIterator& other) const
+  {
+    return other < *this;
+  }
+
+  bool operator<=(const ConstIterator& other) const
+  {
+    return !(other < *this);
+  }
+
+  bool operator>=(const ConstIterator& other) const
+  {
+    return !(*this < other);
+  }
+};
+
+}
+
+#endif /* AISDI_CONCURRENT_CONCURRENTVECTOR_H */
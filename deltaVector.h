@@ -0,0 +1,353 @@
+#ifndef AISDI_LINEAR_DELTAVECTOR_H
+#define AISDI_LINEAR_DELTAVECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+
+#include "vector.h"
+
+namespace aisdi
+{
+
+//non-decreasing sequence of unsigned 64-bit values compressed in blocks of BLOCK values:
+//a block keeps its first value and its smallest gap between neighbours as they are,
+//the other gaps are stored minus the smallest one in the fewest bits fitting them all
+//(delta coding with a frame of reference per block), so a sequence with a steady
+//stride takes no bits per value at all
+//reading value i adds up the gaps of its block up to i, the iterators decode whole
+//blocks; the last, incomplete block is kept uncompressed
+class DeltaVector
+{
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = std::uint64_t;
+
+  class ConstIterator;
+  using const_iterator = ConstIterator;
+
+  static constexpr size_type BLOCK = 128;
+
+  DeltaVector() : _tailSize(0), _size(0) {}
+
+  value_type operator[](size_type index) const
+  {
+    size_type block = index / BLOCK, position = index % BLOCK;
+    if(block == _blocks.getSize()) return _tail[position];
+
+    const Block &b = _blocks[block];
+    if(b.width == 0) return b.first + position * b.minGap;
+    value_type value = b.first + position * b.minGap;
+    const std::uint64_t *words = _words.data() + b.offset;
+    for(size_type i = 0; i < position; ++i) value += readBits(words, i * b.width, b.width);
+    return value;
+  }
+
+  bool isEmpty() const
+  {
+    return !_size;
+  }
+
+  size_type getSize() const
+  {
+    return _size;
+  }
+
+  //bytes taken by the compressed blocks and the uncompressed tail
+  size_type getBytes() const
+  {
+    return _blocks.capacity() * sizeof(Block) + _words.capacity() * sizeof(std::uint64_t) + sizeof(_tail);
+  }
+
+  //values must come in non-decreasing order
+  void append(value_type value)
+  {
+    if(_size && value < back()) throw std::logic_error("DeltaVector needs non-decreasing values");
+
+    _tail[_tailSize++] = value;
+    ++_size;
+    if(_tailSize == BLOCK){
+        try{
+            compressTail();
+        }
+        catch(...){
+            //the value is taken back, a full tail would be written past its end
+            --_tailSize;
+            --_size;
+            throw;
+        }
+    }
+  }
+
+  value_type popLast()
+  {
+    if(isEmpty()) throw std::logic_error("Popping element when the vector is empty");
+
+    if(_tailSize == 0){
+        decodeBlock(_blocks.getSize() - 1, _tail);
+        size_type offset = _blocks[_blocks.getSize() - 1].offset;
+        while(_words.getSize() > offset) _words.popLast();
+        _blocks.popLast();
+        _tailSize = BLOCK;
+    }
+    --_size;
+    return _tail[--_tailSize];
+  }
+
+  value_type back() const
+  {
+    if(isEmpty()) throw std::logic_error("Reading the last element of an empty vector");
+    return _tailSize ? _tail[_tailSize - 1] : (*this)[_size - 1];
+  }
+
+  void clear()
+  {
+    _blocks.clear();
+    _words.clear();
+    _tailSize = 0;
+    _size = 0;
+  }
+
+  //index of the first value not less than 'value', getSize() if there is none
+  size_type lowerBound(value_type value) const
+  {
+    //blocks starting below 'value', the answer lies in the last of them or right after it
+    size_type low = 0, high = blockCount();
+    while(low < high){
+        size_type middle = low + (high - low) / 2;
+        if(firstOf(middle) < value) low = middle + 1;
+        else high = middle;
+    }
+    if(low == 0) return 0;
+
+    value_type values[BLOCK];
+    size_type count = decodeBlock(low - 1, values);
+    size_type i = 0;
+    while(i < count && values[i] < value) ++i;
+    return (low - 1) * BLOCK + i;
+  }
+
+  bool contains(value_type value) const
+  {
+    size_type index = lowerBound(value);
+    return index < _size && (*this)[index] == value;
+  }
+
+  //blocks including the uncompressed tail, block b holds values [b * BLOCK, (b + 1) * BLOCK)
+  size_type blockCount() const
+  {
+    return _blocks.getSize() + (_tailSize ? 1 : 0);
+  }
+
+  //writes the values of a block to 'out', which must have room for BLOCK of them;
+  //returns their number
+  size_type decodeBlock(size_type block, value_type *out) const
+  {
+    if(block == _blocks.getSize()){
+        for(size_type i = 0; i < _tailSize; ++i) out[i] = _tail[i];
+        return _tailSize;
+    }
+
+    const Block &b = _blocks[block];
+    value_type value = b.first;
+    out[0] = value;
+    if(b.width == 0){
+        for(size_type i = 1; i < BLOCK; ++i) out[i] = value += b.minGap;
+        return BLOCK;
+    }
+    const std::uint64_t *words = _words.data() + b.offset;
+    for(size_type i = 1; i < BLOCK; ++i) out[i] = value += b.minGap + readBits(words, (i - 1) * b.width, b.width);
+    return BLOCK;
+  }
+
+  bool operator==(const DeltaVector& other) const
+  {
+    if(_size != other._size) return false;
+    value_type mine[BLOCK], theirs[BLOCK];
+    for(size_type block = 0; block < blockCount(); ++block){
+        size_type count = decodeBlock(block, mine);
+        other.decodeBlock(block, theirs);
+        for(size_type i = 0; i < count; ++i)
+            if(mine[i] != theirs[i]) return false;
+    }
+    return true;
+  }
+
+  bool operator!=(const DeltaVector& other) const
+  {
+    return !(*this == other);
+  }
+
+  const_iterator begin() const;
+  const_iterator end() const;
+  const_iterator cbegin() const;
+  const_iterator cend() const;
+
+private:
+  struct Block{
+    value_type first;
+    value_type minGap;
+    //first word of the packed gaps
+    size_type offset;
+    unsigned width;
+  };
+
+  Vector<Block> _blocks;
+  Vector<std::uint64_t> _words;
+  value_type _tail[BLOCK];
+  size_type _tailSize;
+  size_type _size;
+
+  static value_type readBits(const std::uint64_t *words, size_type bit, unsigned width)
+  {
+    size_type word = bit / 64, offset = bit % 64;
+    value_type value = words[word] >> offset;
+    if(offset + width > 64) value |= words[word + 1] << (64 - offset);
+    return width == 64 ? value : value & ((value_type(1) << width) - 1);
+  }
+
+  //expects the words to be zero
+  static void writeBits(std::uint64_t *words, size_type bit, unsigned width, value_type value)
+  {
+    size_type word = bit / 64, offset = bit % 64;
+    words[word] |= value << offset;
+    if(offset + width > 64) words[word + 1] |= value >> (64 - offset);
+  }
+
+  static unsigned bitsFor(value_type value)
+  {
+    return value ? 64 - __builtin_clzll(value) : 0;
+  }
+
+  value_type firstOf(size_type block) const
+  {
+    return block == _blocks.getSize() ? _tail[0] : _blocks[block].first;
+  }
+
+  //leaves the blocks as they were if it throws
+  void compressTail()
+  {
+    value_type minGap = _tail[1] - _tail[0], maxGap = minGap;
+    for(size_type i = 2; i < BLOCK; ++i){
+        value_type gap = _tail[i] - _tail[i-1];
+        if(gap < minGap) minGap = gap;
+        if(gap > maxGap) maxGap = gap;
+    }
+
+    Block b;
+    b.first = _tail[0];
+    b.minGap = minGap;
+    b.offset = _words.getSize();
+    b.width = bitsFor(maxGap - minGap);
+    try{
+        if(b.width){
+            _words.resize(b.offset + ((BLOCK - 1) * b.width + 63) / 64, 0);
+            std::uint64_t *words = _words.data() + b.offset;
+            for(size_type i = 1; i < BLOCK; ++i) writeBits(words, (i - 1) * b.width, b.width, _tail[i] - _tail[i-1] - minGap);
+        }
+        _blocks.append(b);
+    }
+    catch(...){
+        _words.resize(b.offset);
+        throw;
+    }
+    _tailSize = 0;
+  }
+};
+
+//decodes a whole block when it steps into it; values are returned by value, as the
+//decoded block belongs to the iterator and a reference into it would change with it
+class DeltaVector::ConstIterator
+{
+protected:
+  const DeltaVector *vec;
+
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = DeltaVector::value_type;
+  using difference_type = DeltaVector::difference_type;
+  using pointer = void;
+  using reference = value_type;
+
+  size_t position;
+
+  ConstIterator() : vec(nullptr), position(0), decoded(NONE) {}
+
+  explicit ConstIterator(const DeltaVector &v, size_t pos) : vec(&v), position(pos), decoded(NONE) {}
+
+  ConstIterator(const ConstIterator& other) : vec(other.vec), position(other.position), decoded(NONE) {}
+
+  ConstIterator& operator=(const ConstIterator& other)
+  {
+    vec = other.vec;
+    position = other.position;
+    decoded = NONE;
+    return *this;
+  }
+
+  reference operator*() const
+  {
+    if(this->position == vec->getSize()) throw std::out_of_range("Tried to get value of end() element");
+    size_t block = position / DeltaVector::BLOCK;
+    if(block != decoded){
+        vec->decodeBlock(block, values);
+        decoded = block;
+    }
+    return values[position % DeltaVector::BLOCK];
+  }
+
+  ConstIterator& operator++()
+  {
+    if(++(this->position) > vec->getSize()) throw std::out_of_range("Array exceeded");
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator tmp = *this;
+    ++(*this);
+    return tmp;
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return this->position == other.position;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+
+private:
+  static const size_t NONE = static_cast<size_t>(-1);
+
+  mutable size_t decoded;
+  mutable value_type values[DeltaVector::BLOCK];
+};
+
+inline DeltaVector::const_iterator DeltaVector::begin() const
+{
+  return const_iterator(*this, 0);
+}
+
+inline DeltaVector::const_iterator DeltaVector::end() const
+{
+  return const_iterator(*this, _size);
+}
+
+inline DeltaVector::const_iterator DeltaVector::cbegin() const
+{
+  return begin();
+}
+
+inline DeltaVector::const_iterator DeltaVector::cend() const
+{
+  return end();
+}
+
+}
+
+#endif /* AISDI_LINEAR_DELTAVECTOR_H */
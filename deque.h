@@ -0,0 +1,585 @@
+#ifndef AISDI_LINEAR_DEQUE_H
+#define AISDI_LINEAR_DEQUE_H
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace aisdi
+{
+
+//double-ended queue on a growable ring buffer; the capacity is a power of two, so
+//wrapping around is a mask and both ends take amortized O(1)
+//the API follows Vector and LinkedList
+template <typename Type>
+class Deque
+{
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = Type;
+  using pointer = Type*;
+  using reference = Type&;
+  using const_pointer = const Type*;
+  using const_reference = const Type&;
+
+  class ConstIterator;
+  class Iterator;
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+
+  Deque() : _buffer(nullptr), _capacity(0), _head(0), _size(0) {}
+
+  Deque(std::initializer_list<Type> l) : Deque()
+  {
+    reserve(l.size());
+    for(auto &i : l) append(i);
+  }
+
+  Deque(const Deque& other) : Deque()
+  {
+    reserve(other._size);
+    for(size_type i = 0; i < other._size; ++i) append(other[i]);
+  }
+
+  Deque(Deque&& other) noexcept : _buffer(other._buffer), _capacity(other._capacity), _head(other._head), _size(other._size)
+  {
+    other._buffer = nullptr;
+    other._capacity = other._head = other._size = 0;
+  }
+
+  ~Deque()
+  {
+    destroyElements();
+    deallocate(_buffer);
+  }
+
+  Deque& operator=(const Deque& other)
+  {
+    if(&other == this) return *this;
+
+    destroyElements();
+    reserve(other._size);
+    for(size_type i = 0; i < other._size; ++i) append(other[i]);
+    return *this;
+  }
+
+  Deque& operator=(Deque&& other) noexcept
+  {
+    if(&other == this) return *this;
+
+    destroyElements();
+    deallocate(_buffer);
+    _buffer = other._buffer;
+    _capacity = other._capacity;
+    _head = other._head;
+    _size = other._size;
+    other._buffer = nullptr;
+    other._capacity = other._head = other._size = 0;
+    return *this;
+  }
+
+  const Type& operator[](size_type index) const
+  {
+    return _buffer[(_head + index) & (_capacity - 1)];
+  }
+
+  Type& operator[](size_type index)
+  {
+    return _buffer[(_head + index) & (_capacity - 1)];
+  }
+
+  bool isEmpty() const
+  {
+    return !_size;
+  }
+
+  size_type getSize() const
+  {
+    return _size;
+  }
+
+  size_type capacity() const
+  {
+    return _capacity;
+  }
+
+  //makes room for at least 'count' elements, rounded up to a power of two
+  void reserve(size_type count)
+  {
+    if(count <= _capacity) return;
+    size_type newCapacity = _capacity ? _capacity : MIN_CAPACITY;
+    while(newCapacity < count) newCapacity *= 2;
+    reallocate(newCapacity);
+  }
+
+  void append(const Type& item)
+  {
+    emplaceBack(item);
+  }
+
+  void append(Type&& item)
+  {
+    emplaceBack(std::move(item));
+  }
+
+  template <typename... Args>
+  Type& emplaceBack(Args&&... args)
+  {
+    if(_size == _capacity){
+        //args may refer to an element, so the value is built before the storage moves
+        Type item(std::forward<Args>(args)...);
+        grow();
+        new (slot(_size)) Type(std::move(item));
+    }
+    else new (slot(_size)) Type(std::forward<Args>(args)...);
+    return (*this)[_size++];
+  }
+
+  void prepend(const Type& item)
+  {
+    emplaceFront(item);
+  }
+
+  void prepend(Type&& item)
+  {
+    emplaceFront(std::move(item));
+  }
+
+  template <typename... Args>
+  Type& emplaceFront(Args&&... args)
+  {
+    if(_size == _capacity){
+        Type item(std::forward<Args>(args)...);
+        grow();
+        new (slot(_capacity - 1)) Type(std::move(item));
+    }
+    else new (slot(_capacity - 1)) Type(std::forward<Args>(args)...);
+    _head = (_head - 1) & (_capacity - 1);
+    ++_size;
+    return (*this)[0];
+  }
+
+  void insert(const const_iterator& insertPosition, const Type& item)
+  {
+    emplace(insertPosition, item);
+  }
+
+  void insert(const const_iterator& insertPosition, Type&& item)
+  {
+    emplace(insertPosition, std::move(item));
+  }
+
+  //shifts the shorter side of the queue to make room
+  template <typename... Args>
+  iterator emplace(const const_iterator& insertPosition, Args&&... args)
+  {
+    size_type pos = insertPosition.position;
+    if(pos > _size) throw std::out_of_range("Inserting beyond the end()");
+
+    if(pos == _size){
+        emplaceBack(std::forward<Args>(args)...);
+        return iterator(*this, pos);
+    }
+    if(pos == 0){
+        emplaceFront(std::forward<Args>(args)...);
+        return iterator(*this, pos);
+    }
+
+    Type item(std::forward<Args>(args)...);
+    if(_size == _capacity) grow();
+
+    Deque &self = *this;
+    if(pos < _size - pos){
+        new (slot(_capacity - 1)) Type(std::move(self[0]));
+        _head = (_head - 1) & (_capacity - 1);
+        ++_size;
+        for(size_type i = 1; i < pos; ++i) self[i] = std::move(self[i+1]);
+    }
+    else{
+        new (slot(_size)) Type(std::move(self[_size-1]));
+        ++_size;
+        for(size_type i = _size-2; i > pos; --i) self[i] = std::move(self[i-1]);
+    }
+    self[pos] = std::move(item);
+    return iterator(*this, pos);
+  }
+
+  Type popFirst()
+  {
+    if(isEmpty()) throw std::logic_error("Popping element when the deque is empty");
+
+    Type value = std::move(_buffer[_head]);
+    _buffer[_head].~Type();
+    _head = (_head + 1) & (_capacity - 1);
+    --_size;
+    return value;
+  }
+
+  Type popLast()
+  {
+    if(isEmpty()) throw std::logic_error("Popping element when the deque is empty");
+
+    Type &last = (*this)[_size-1];
+    Type value = std::move(last);
+    last.~Type();
+    --_size;
+    return value;
+  }
+
+  void erase(const const_iterator& position)
+  {
+    if(isEmpty()) throw std::out_of_range("Erasing when deque is empty");
+    if(position.position >= _size) throw std::out_of_range("Erasing end() element");
+
+    erase(position, position + 1);
+  }
+
+  //shifts the shorter of the parts around the gap
+  void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+  {
+    size_type first = firstIncluded.position, last = lastExcluded.position;
+    if(first > last || last > _size) throw std::out_of_range("Erasing beyond the deque");
+    if(first == last) return;
+
+    Deque &self = *this;
+    size_type count = last - first;
+    if(first < _size - last){
+        for(size_type i = first; i > 0; --i) self[i-1+count] = std::move(self[i-1]);
+        for(size_type i = 0; i < count; ++i) self[i].~Type();
+        _head = (_head + count) & (_capacity - 1);
+    }
+    else{
+        for(size_type i = last; i < _size; ++i) self[i-count] = std::move(self[i]);
+        for(size_type i = _size - count; i < _size; ++i) self[i].~Type();
+    }
+    _size -= count;
+  }
+
+  //drops the elements, the buffer is kept
+  void clear()
+  {
+    destroyElements();
+  }
+
+  iterator begin()
+  {
+    return iterator(*this, 0);
+  }
+
+  iterator end()
+  {
+    return iterator(*this, _size);
+  }
+
+  const_iterator cbegin() const
+  {
+    return const_iterator(*this, 0);
+  }
+
+  const_iterator cend() const
+  {
+    return const_iterator(*this, _size);
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+
+private:
+  static const size_type MIN_CAPACITY = 16;
+  static const bool BITWISE = std::is_trivially_copyable<Type>::value;
+
+  //elements occupy slots _head, _head+1, ... modulo _capacity
+  pointer _buffer;
+  size_type _capacity, _head, _size;
+
+  //raw slot the element of the given logical index goes to, indices wrap around
+  pointer slot(size_type index)
+  {
+    return _buffer + ((_head + index) & (_capacity - 1));
+  }
+
+  static pointer allocate(size_type count)
+  {
+    if(alignof(Type) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        return static_cast<pointer>(::operator new(count * sizeof(Type), std::align_val_t(alignof(Type))));
+    return static_cast<pointer>(::operator new(count * sizeof(Type)));
+  }
+
+  static void deallocate(pointer p)
+  {
+    if(p == nullptr) return;
+    if(alignof(Type) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) ::operator delete(p, std::align_val_t(alignof(Type)));
+    else ::operator delete(p);
+  }
+
+  void destroyElements()
+  {
+    for(size_type i = 0; i < _size; ++i) (*this)[i].~Type();
+    _head = _size = 0;
+  }
+
+  void grow()
+  {
+    reallocate(_capacity ? _capacity * 2 : MIN_CAPACITY);
+  }
+
+  //moves the elements to a new buffer, unwrapped so that the first one is in slot 0
+  void reallocate(size_type newCapacity)
+  {
+    pointer newBuffer = allocate(newCapacity);
+    if(BITWISE){
+        size_type firstPart = _size < _capacity - _head ? _size : _capacity - _head;
+        if(firstPart) std::memcpy(static_cast<void*>(newBuffer), _buffer + _head, firstPart * sizeof(Type));
+        if(_size > firstPart) std::memcpy(static_cast<void*>(newBuffer + firstPart), _buffer, (_size - firstPart) * sizeof(Type));
+    }
+    else{
+        size_type built = 0;
+        try{
+            for(; built < _size; ++built) new (newBuffer + built) Type(std::move_if_noexcept((*this)[built]));
+        }
+        catch(...){
+            for(size_type i = 0; i < built; ++i) newBuffer[i].~Type();
+            deallocate(newBuffer);
+            throw;
+        }
+        for(size_type i = 0; i < _size; ++i) (*this)[i].~Type();
+    }
+    deallocate(_buffer);
+    _buffer = newBuffer;
+    _capacity = newCapacity;
+    _head = 0;
+  }
+};
+
+template <typename Type>
+class Deque<Type>::ConstIterator
+{
+protected:
+  const Deque *deq;
+
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename Deque::value_type;
+  using difference_type = typename Deque::difference_type;
+  using pointer = typename Deque::const_pointer;
+  using reference = typename Deque::const_reference;
+
+  size_t position;
+
+  ConstIterator() : deq(nullptr), position(0) {}
+
+  explicit ConstIterator(const Deque &d, size_t pos) : deq(&d), position(pos) {}
+
+  reference operator*() const
+  {
+    if(this->position == deq->getSize()) throw std::out_of_range("Tried to get value of end() element");
+    return (*deq)[position];
+  }
+
+  pointer operator->() const
+  {
+    return &this->operator*();
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return (*deq)[position + d];
+  }
+
+  ConstIterator& operator++()
+  {
+    if(++(this->position) > deq->getSize()) throw std::out_of_range("Deque exceeded");
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator tmp = *this;
+    ++(*this);
+    return tmp;
+  }
+
+  ConstIterator& operator--()
+  {
+    if(this->position == 0) throw std::out_of_range("Deque exceeded");
+    this->position--;
+    return *this;
+  }
+
+  ConstIterator operator--(int)
+  {
+    ConstIterator tmp = *this;
+    --(*this);
+    return tmp;
+  }
+
+  ConstIterator& operator+=(difference_type d)
+  {
+    difference_type target = static_cast<difference_type>(this->position) + d;
+    if(target < 0 || target > static_cast<difference_type>(deq->getSize())) throw std::out_of_range("Deque exceeded");
+    this->position = target;
+    return *this;
+  }
+
+  ConstIterator& operator-=(difference_type d)
+  {
+    return *this += -d;
+  }
+
+  ConstIterator operator+(difference_type d) const
+  {
+    ConstIterator tmp = *this;
+    return tmp += d;
+  }
+
+  friend ConstIterator operator+(difference_type d, const ConstIterator& it)
+  {
+    return it + d;
+  }
+
+  ConstIterator operator-(difference_type d) const
+  {
+    ConstIterator tmp = *this;
+    return tmp -= d;
+  }
+
+  difference_type operator-(const ConstIterator& other) const
+  {
+    return static_cast<difference_type>(this->position) - static_cast<difference_type>(other.position);
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return this->position == other.position;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+
+  bool operator<(const ConstIterator& other) const
+  {
+    return this->position < other.position;
+  }
+
+  bool operator>(const ConstIterator& other) const
+  {
+    return other < *this;
+  }
+
+  bool operator<=(const ConstIterator& other) const
+  {
+    return !(other < *this);
+  }
+
+  bool operator>=(const ConstIterator& other) const
+  {
+    return !(*this < other);
+  }
+};
+
+template <typename Type>
+class Deque<Type>::Iterator : public Deque<Type>::ConstIterator
+{
+public:
+  using pointer = typename Deque::pointer;
+  using reference = typename Deque::reference;
+
+  Iterator()
+  {}
+
+  Iterator(const ConstIterator& other)
+    : ConstIterator(other)
+  {}
+
+  explicit Iterator(Deque &d, size_t pos) : ConstIterator(d, pos) {}
+
+  Iterator& operator++()
+  {
+    ConstIterator::operator++();
+    return *this;
+  }
+
+  Iterator operator++(int)
+  {
+    auto result = *this;
+    ConstIterator::operator++();
+    return result;
+  }
+
+  Iterator& operator--()
+  {
+    ConstIterator::operator--();
+    return *this;
+  }
+
+  Iterator operator--(int)
+  {
+    auto result = *this;
+    ConstIterator::operator--();
+    return result;
+  }
+
+  Iterator& operator+=(difference_type d)
+  {
+    ConstIterator::operator+=(d);
+    return *this;
+  }
+
+  Iterator& operator-=(difference_type d)
+  {
+    ConstIterator::operator-=(d);
+    return *this;
+  }
+
+  Iterator operator+(difference_type d) const
+  {
+    return ConstIterator::operator+(d);
+  }
+
+  friend Iterator operator+(difference_type d, const Iterator& it)
+  {
+    return it + d;
+  }
+
+  Iterator operator-(difference_type d) const
+  {
+    return ConstIterator::operator-(d);
+  }
+
+  using ConstIterator::operator-;
+
+  reference operator*() const
+  {
+    // ugly cast, yet reduces code duplication.
+    return const_cast<reference>(ConstIterator::operator*());
+  }
+
+  pointer operator->() const
+  {
+    return &this->operator*();
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return const_cast<reference>(ConstIterator::operator[](d));
+  }
+};
+
+}
+
+#endif /* AISDI_LINEAR_DEQUE_H */
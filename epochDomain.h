@@ -0,0 +1,169 @@
+#ifndef AISDI_CONCURRENT_EPOCHDOMAIN_H
+#define AISDI_CONCURRENT_EPOCHDOMAIN_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace aisdi
+{
+
+//epoch based memory reclamation shared by the lock-free containers
+//a thread enters a critical region with a Guard, objects unlinked from a
+//shared structure are handed to retire() and are deleted only after every
+//thread that could still see them has left its critical region
+class EpochDomain
+{
+public:
+  using size_type = std::size_t;
+  using deleter_type = void (*)(void*);
+
+  class Guard;
+
+  static EpochDomain& instance()
+  {
+    static EpochDomain domain;
+    return domain;
+  }
+
+  //must be called from inside a Guard
+  void retire(void *object, deleter_type deleter)
+  {
+    ThreadRecord *record = localRecord();
+    record->limbo.push_back(Retired{object, deleter, _globalEpoch.load()});
+    if(++record->retiredSinceScan >= SCAN_THRESHOLD){
+        record->retiredSinceScan = 0;
+        tryAdvance();
+        reclaim(record);
+    }
+  }
+
+  ~EpochDomain()
+  {
+    //no thread can be inside a critical region while statics are destroyed
+    ThreadRecord *record = _records.load();
+    while(record != nullptr){
+        ThreadRecord *next = record->next;
+        for(auto &r : record->limbo) r.deleter(r.object);
+        delete record;
+        record = next;
+    }
+  }
+
+private:
+  static const size_type SCAN_THRESHOLD = 64;
+  //the lowest bit of a record's state tells whether the thread is inside a critical region
+  static const std::uint64_t ACTIVE = 1;
+
+  struct Retired{
+    void *object;
+    deleter_type deleter;
+    std::uint64_t epoch;
+  };
+
+  struct ThreadRecord{
+    std::atomic<std::uint64_t> state;
+    std::atomic<bool> inUse;
+    ThreadRecord *next;
+    //owned by the thread holding the record
+    unsigned nesting;
+    size_type retiredSinceScan;
+    std::vector<Retired> limbo;
+
+    ThreadRecord() : state(0), inUse(true), next(nullptr), nesting(0), retiredSinceScan(0) {}
+  };
+
+  //releases the record when its thread exits so that another thread can adopt it
+  struct LocalHolder{
+    ThreadRecord *record = nullptr;
+    ~LocalHolder(){ if(record != nullptr) record->inUse.store(false); }
+  };
+
+  std::atomic<std::uint64_t> _globalEpoch;
+  std::atomic<ThreadRecord*> _records;
+
+  EpochDomain() : _globalEpoch(0), _records(nullptr) {}
+  EpochDomain(const EpochDomain&) = delete;
+  EpochDomain& operator=(const EpochDomain&) = delete;
+
+  ThreadRecord* localRecord()
+  {
+    static thread_local LocalHolder holder;
+    if(holder.record == nullptr) holder.record = acquireRecord();
+    return holder.record;
+  }
+
+  ThreadRecord* acquireRecord()
+  {
+    //reusing a record of a finished thread, its limbo list is adopted as well
+    for(ThreadRecord *r = _records.load(); r != nullptr; r = r->next){
+        bool expected = false;
+        if(!r->inUse.load() && r->inUse.compare_exchange_strong(expected, true)) return r;
+    }
+
+    ThreadRecord *record = new ThreadRecord;
+    ThreadRecord *head = _records.load();
+    do record->next = head;
+    while(!_records.compare_exchange_weak(head, record));
+    return record;
+  }
+
+  void enter()
+  {
+    ThreadRecord *record = localRecord();
+    if(record->nesting++) return;
+    record->state.store((_globalEpoch.load() << 1) | ACTIVE);
+  }
+
+  void exit()
+  {
+    ThreadRecord *record = localRecord();
+    if(--record->nesting) return;
+    record->state.store(0);
+  }
+
+  //the epoch moves forward only when every active thread has observed the current one
+  void tryAdvance()
+  {
+    std::uint64_t epoch = _globalEpoch.load();
+    for(ThreadRecord *r = _records.load(); r != nullptr; r = r->next){
+        std::uint64_t state = r->state.load();
+        if((state & ACTIVE) && (state >> 1) != epoch) return;
+    }
+    _globalEpoch.compare_exchange_strong(epoch, epoch + 1);
+  }
+
+  //an object retired in epoch e can't be reached by anyone once the global epoch is e+2
+  void reclaim(ThreadRecord *record)
+  {
+    std::uint64_t epoch = _globalEpoch.load();
+    size_type kept = 0;
+    for(size_type i = 0; i < record->limbo.size(); ++i){
+        Retired r = record->limbo[i];
+        if(r.epoch + 2 <= epoch) r.deleter(r.object);
+        else record->limbo[kept++] = r;
+    }
+    record->limbo.resize(kept);
+  }
+};
+
+//pins the calling thread in the current epoch for its lifetime, guards nest
+class EpochDomain::Guard
+{
+public:
+  Guard() : _domain(&EpochDomain::instance()) { _domain->enter(); }
+
+  Guard(const Guard& other) : _domain(other._domain) { _domain->enter(); }
+
+  Guard& operator=(const Guard&) { return *this; }
+
+  ~Guard() { _domain->exit(); }
+
+private:
+  EpochDomain *_domain;
+};
+
+}
+
+#endif /* AISDI_CONCURRENT_EPOCHDOMAIN_H */
@@ -0,0 +1,428 @@
+#ifndef AISDI_MAPS_FLATMAP_H
+#define AISDI_MAPS_FLATMAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+namespace aisdi
+{
+
+//ordered map kept as sorted keys in one Vector and their values in a parallel one
+//lookups are a branch-free binary search over the keys only, so small and medium maps
+//that are read much more than written beat the node based TreeMap; a single insert or
+//remove shifts the elements after it, insertBulk() takes many at the cost of one merge
+template <typename KeyType, typename ValueType>
+class FlatMap
+{
+public:
+  using key_type = KeyType;
+  using mapped_type = ValueType;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using size_type = std::size_t;
+  //elements are not stored as pairs, iterators hand out pairs of references
+  using reference = std::pair<const key_type&, mapped_type&>;
+  using const_reference = std::pair<const key_type&, const mapped_type&>;
+
+  class ConstIterator;
+  class Iterator;
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+
+  FlatMap() {}
+
+  FlatMap(std::initializer_list<value_type> list) : FlatMap()
+  {
+    insertBulk(list.begin(), list.end());
+  }
+
+  bool isEmpty() const
+  {
+    return _keys.isEmpty();
+  }
+
+  size_type getSize() const
+  {
+    return _keys.getSize();
+  }
+
+  void reserve(size_type count)
+  {
+    _keys.reserve(count);
+    _values.reserve(count);
+  }
+
+  mapped_type& operator[](const key_type& key)
+  {
+    size_type index = search(key);
+    if(index == getSize() || key < _keys[index]) emplaceAt(index, key);
+    return _values[index];
+  }
+
+  //inserts the element unless the key is already present, returns the element with the key
+  iterator insert(const key_type& key, const mapped_type& value)
+  {
+    size_type index = search(key);
+    if(index == getSize() || key < _keys[index]) emplaceAt(index, key, value);
+    return iterator(this, index);
+  }
+
+  //adds pairs given in any order: they are sorted once and merged with the map in one pass
+  //instead of shifting the elements for every one of them
+  //as with insert(), keys already in the map, or repeated in the input, keep the first value
+  template <typename InputIterator>
+  void insertBulk(InputIterator first, InputIterator last)
+  {
+    Vector<std::pair<key_type, mapped_type>> batch;
+    for(; first != last; ++first) batch.emplaceBack(first->first, first->second);
+    if(batch.isEmpty()) return;
+
+    using Pair = std::pair<key_type, mapped_type>;
+    std::stable_sort(batch.begin(), batch.end(), [](const Pair &a, const Pair &b){ return a.first < b.first; });
+
+    //the merged arrays are built aside; our elements are moved into them only when no
+    //key or value move can throw, otherwise copied, so a throw leaves the map as it was
+    constexpr bool MOVE = std::is_nothrow_move_constructible<key_type>::value && std::is_nothrow_move_constructible<mapped_type>::value;
+    Vector<key_type> keys;
+    Vector<mapped_type> values;
+    keys.reserve(getSize() + batch.getSize());
+    values.reserve(getSize() + batch.getSize());
+    size_type i = 0, j = 0;
+    while(i < getSize() || j < batch.getSize()){
+        if(j == batch.getSize() || (i < getSize() && !(batch[j].first < _keys[i]))){
+            //equal keys: the one in the map stays
+            while(j < batch.getSize() && !(_keys[i] < batch[j].first)) ++j;
+            if constexpr(MOVE){
+                keys.append(std::move(_keys[i]));
+                values.append(std::move(_values[i]));
+            }
+            else{
+                keys.append(_keys[i]);
+                values.append(_values[i]);
+            }
+            ++i;
+        }
+        else{
+            keys.append(std::move(batch[j].first));
+            values.append(std::move(batch[j].second));
+            //a repeated key in the input keeps its first value
+            for(++j; j < batch.getSize() && !(keys[keys.getSize()-1] < batch[j].first); ++j);
+        }
+    }
+    _keys = std::move(keys);
+    _values = std::move(values);
+  }
+
+  template <typename Range>
+  void insertBulk(const Range& range)
+  {
+    insertBulk(range.begin(), range.end());
+  }
+
+  const mapped_type& valueOf(const key_type& key) const
+  {
+    size_type index = search(key);
+    if(index == getSize() || key < _keys[index]) throw std::out_of_range("ValueOf didn't find the element");
+    return _values[index];
+  }
+
+  mapped_type& valueOf(const key_type& key)
+  {
+    return const_cast<mapped_type&>(static_cast<const FlatMap*>(this)->valueOf(key));
+  }
+
+  bool contains(const key_type& key) const
+  {
+    size_type index = search(key);
+    return index != getSize() && !(key < _keys[index]);
+  }
+
+  const_iterator find(const key_type& key) const
+  {
+    size_type index = search(key);
+    if(index == getSize() || key < _keys[index]) return cend();
+    return const_iterator(this, index);
+  }
+
+  iterator find(const key_type& key)
+  {
+    return iterator(static_cast<const FlatMap*>(this)->find(key));
+  }
+
+  //first element whose key is not less than the given one
+  const_iterator lowerBound(const key_type& key) const
+  {
+    return const_iterator(this, search(key));
+  }
+
+  iterator lowerBound(const key_type& key)
+  {
+    return iterator(this, search(key));
+  }
+
+  void remove(const key_type& key)
+  {
+    const_iterator it = find(key);
+    if(it == cend()) throw std::out_of_range("Remove didn't find the element");
+    remove(it);
+  }
+
+  void remove(const const_iterator& it)
+  {
+    if(it._index >= getSize()) throw std::out_of_range("Removing end() element");
+    _keys.erase(typename Vector<key_type>::const_iterator(_keys, it._index));
+    _values.erase(typename Vector<mapped_type>::const_iterator(_values, it._index));
+  }
+
+  void clear()
+  {
+    _keys.clear();
+    _values.clear();
+  }
+
+  //the sorted keys and their values, both getSize() long
+  const key_type* keys() const
+  {
+    return _keys.data();
+  }
+
+  const mapped_type* values() const
+  {
+    return _values.data();
+  }
+
+  mapped_type* values()
+  {
+    return _values.data();
+  }
+
+  bool operator==(const FlatMap& other) const
+  {
+    if(getSize() != other.getSize()) return false;
+    for(size_type i = 0; i < getSize(); ++i)
+        if( (_keys[i] != other._keys[i]) || (_values[i] != other._values[i]) ) return false;
+    return true;
+  }
+
+  bool operator!=(const FlatMap& other) const
+  {
+    return !(*this == other);
+  }
+
+  iterator begin()
+  {
+    return iterator(this, 0);
+  }
+
+  iterator end()
+  {
+    return iterator(this, getSize());
+  }
+
+  const_iterator cbegin() const
+  {
+    return const_iterator(this, 0);
+  }
+
+  const_iterator cend() const
+  {
+    return const_iterator(this, getSize());
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+
+private:
+  Vector<key_type> _keys;
+  Vector<mapped_type> _values;
+
+  //index of the first key not less than the given one, getSize() if there is none
+  //the range halves every step whatever the comparison says, so it compiles to a
+  //conditional move instead of a hard to predict branch
+  size_type search(const key_type &key) const
+  {
+    size_type count = getSize();
+    if(count == 0) return 0;
+
+    const key_type *base = _keys.data();
+    while(count > 1){
+        size_type half = count / 2;
+#if defined(__GNUC__)
+        //both possible next probes, one of them will be needed
+        __builtin_prefetch(base + half / 2);
+        __builtin_prefetch(base + half + half / 2);
+#endif
+        base = base[half] < key ? base + half : base;
+        count -= half;
+    }
+    return (base - _keys.data()) + (*base < key);
+  }
+
+  //the value is added after the key, a throw while adding it takes the key back
+  template <typename... Args>
+  void emplaceAt(size_type index, const key_type &key, Args&&... args)
+  {
+    _keys.emplace(typename Vector<key_type>::const_iterator(_keys, index), key);
+    try{
+        _values.emplace(typename Vector<mapped_type>::const_iterator(_values, index), std::forward<Args>(args)...);
+    }
+    catch(...){
+        _keys.erase(typename Vector<key_type>::const_iterator(_keys, index));
+        throw;
+    }
+  }
+};
+
+template <typename KeyType, typename ValueType>
+class FlatMap<KeyType, ValueType>::ConstIterator
+{
+public:
+  using reference = typename FlatMap::const_reference;
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = typename FlatMap::value_type;
+  using difference_type = std::ptrdiff_t;
+
+  //lets it->first and it->second work on a pair built on the fly
+  class pointer
+  {
+  public:
+    explicit pointer(const reference& r) : _r(r) {}
+    const reference* operator->() const { return &_r; }
+  private:
+    reference _r;
+  };
+
+  explicit ConstIterator(const FlatMap *map = nullptr, size_type index = 0) : _map(map), _index(index) {}
+
+  ConstIterator& operator++()
+  {
+    if(_map == nullptr || _index >= _map->getSize()) throw std::out_of_range("Tried to iterate beyond the map");
+    ++_index;
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator result = *this;
+    ++(*this);
+    return result;
+  }
+
+  ConstIterator& operator--()
+  {
+    if(_index == 0) throw std::out_of_range("Tried to iterate beyond the map");
+    --_index;
+    return *this;
+  }
+
+  ConstIterator operator--(int)
+  {
+    ConstIterator result = *this;
+    --(*this);
+    return result;
+  }
+
+  reference operator*() const
+  {
+    if(_map == nullptr || _index >= _map->getSize()) throw std::out_of_range("Tried to get the value of the end()");
+    return reference(_map->_keys[_index], _map->_values[_index]);
+  }
+
+  pointer operator->() const
+  {
+    return pointer(this->operator*());
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return _index == other._index;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+
+protected:
+  friend class FlatMap;
+
+  const FlatMap *_map;
+  size_type _index;
+};
+
+template <typename KeyType, typename ValueType>
+class FlatMap<KeyType, ValueType>::Iterator : public FlatMap<KeyType, ValueType>::ConstIterator
+{
+public:
+  using reference = typename FlatMap::reference;
+
+  class pointer
+  {
+  public:
+    explicit pointer(const reference& r) : _r(r) {}
+    const reference* operator->() const { return &_r; }
+  private:
+    reference _r;
+  };
+
+  explicit Iterator(const FlatMap *map = nullptr, size_type index = 0) : ConstIterator(map, index) {}
+
+  Iterator(const ConstIterator& other)
+    : ConstIterator(other)
+  {}
+
+  Iterator& operator++()
+  {
+    ConstIterator::operator++();
+    return *this;
+  }
+
+  Iterator operator++(int)
+  {
+    auto result = *this;
+    ConstIterator::operator++();
+    return result;
+  }
+
+  Iterator& operator--()
+  {
+    ConstIterator::operator--();
+    return *this;
+  }
+
+  Iterator operator--(int)
+  {
+    auto result = *this;
+    ConstIterator::operator--();
+    return result;
+  }
+
+  pointer operator->() const
+  {
+    return pointer(this->operator*());
+  }
+
+  reference operator*() const
+  {
+    typename ConstIterator::reference r = ConstIterator::operator*();
+    // ugly cast, yet reduces code duplication.
+    return reference(r.first, const_cast<mapped_type&>(r.second));
+  }
+};
+
+}
+
+#endif /* AISDI_MAPS_FLATMAP_H */
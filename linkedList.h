@@ -3,12 +3,14 @@
 
 #include <cstddef>
 #include <initializer_list>
+#include <iterator>
 #include <stdexcept>
 
 template <typename Type>
 struct Node{
     Type value;
     Node *next;
+    Node *prev;
 };
 
 namespace aisdi
@@ -63,6 +65,8 @@ public:
 
   LinkedList& operator=(const LinkedList& other)
   {
+    if(&other == this) return *this;
+
     wipe();
 
     for(ConstIterator it = other.cbegin(); it != other.cend(); it++) append(*it);
@@ -72,6 +76,8 @@ public:
 
   LinkedList& operator=(LinkedList&& other)
   {
+    if(&other == this) return *this;
+
     wipe();
     this->head = other.head;
     this->tail = other.tail;
@@ -94,55 +100,20 @@ public:
 
   void append(const Type& item)
   {
-    Node<Type> *node = new Node<Type>;
-    node->value = item, node->next = nullptr;
-
-    if(isEmpty()) this->head = this->tail = node;
-    else{
-        this->tail->next = node;
-        this->tail = node;
-    }
-
-    this->size++;
+    linkBefore(nullptr, item);
   }
 
   void prepend(const Type& item)
   {
-    Node<Type> *node = new Node<Type>;
-    node->value = item, node->next = nullptr;
-
-    if(isEmpty()) this->head = this->tail = node;
-    else{
-        node->next = this->head;
-        this->head = node;
-    }
-
-    this->size++;
+    linkBefore(this->head, item);
   }
 
+  //O(1), the iterator holds the node to insert before
   void insert(const const_iterator& insertPosition, const Type& item)
   {
-    if(insertPosition.position > this->size) throw std::out_of_range("Exceeded a list while inserting an element");
-
-    if(insertPosition.position == this->size){
-        append(item);
-        return;
-    }
+    if(insertPosition.list != this) throw std::out_of_range("Inserting at an iterator of another list");
 
-    if(insertPosition.position == 0){
-        prepend(item);
-        return;
-    }
-
-    Node<Type> *node = new Node<Type>;
-    node->value = item, node->next = nullptr;
-
-    Node<Type> *nodeBefore = getElementBefore(insertPosition);
-
-    node->next = nodeBefore->next;
-    nodeBefore->next = node;
-
-    this->size++;
+    linkBefore(insertPosition.node, item);
   }
 
   Type popFirst()
@@ -150,11 +121,7 @@ public:
     if(isEmpty()) throw std::logic_error("Popping element from list when it is empty");
 
     Type temp = this->head->value;
-    Node<Type> *tempPtr = this->head;
-    this->head = this->head->next;
-    delete tempPtr;
-    if(this->size == 1) this->tail = nullptr;
-    this->size--;
+    unlink(this->head);
 
     return temp;
   }
@@ -163,77 +130,72 @@ public:
   {
     if(isEmpty()) throw std::logic_error("Popping an element from a list when it is empty");
 
-    if(this->size == 1){
-        Type temp = this->head->value;
-        delete this->head;
-        this->head = this->tail = nullptr;
-        this->size = 0;
+    Type temp = this->tail->value;
+    unlink(this->tail);
 
-        return temp;
-    }
-
-    Node<Type> *temp = getElementBefore(cend()-1);
-    Type tempValue = this->tail->value;
-    delete this->tail;
-    temp->next = nullptr;
-    this->tail = temp;
-    this->size--;
-
-    return tempValue;
+    return temp;
   }
 
+  //O(1), iterators to other elements stay valid
   void erase(const const_iterator& possition)
   {
+    if(possition.list != this) throw std::out_of_range("Erasing at an iterator of another list");
     if(isEmpty()) throw std::out_of_range("Erasing an element from a list when it is empty");
-    if(possition == end()) throw std::out_of_range("Erasing end() element");
-
-    Node<Type> *nodeBefore = getElementBefore(possition);
+    if(possition.node == nullptr) throw std::out_of_range("Erasing end() element");
 
-    if(nodeBefore == nullptr){
-        Node<Type> *temp = this->head->next;
-        delete this->head;
-        this->head = temp;
-    }
-    else{
-        if(possition.position == this->size-1) this->tail = nodeBefore;
-        Node<Type> *temp = nodeBefore->next->next;
-        delete nodeBefore->next;
-        nodeBefore->next = temp;
-    }
-
-    this->size--;
+    unlink(possition.node);
   }
 
+  //a reversed range is found by walking it before anything is erased
   void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
   {
-    if(lastExcluded.position > this->size) throw std::out_of_range("Exceeding a list while erasing");
+    if(firstIncluded.list != this || lastExcluded.list != this)
+        throw std::out_of_range("Erasing a range of another list");
+
+    Node<Type> *node = firstIncluded.node;
+    while(node != lastExcluded.node){
+        if(node == nullptr) throw std::out_of_range("Exceeding a list while erasing");
+        node = node->next;
+    }
 
-    for(size_type i = 0; i < lastExcluded.position - firstIncluded.position; i++) erase(firstIncluded);
+    node = firstIncluded.node;
+    while(node != lastExcluded.node){
+        Node<Type> *next = node->next;
+        unlink(node);
+        node = next;
+    }
   }
 
   void wipe()
   {
-    while(this->size) erase(begin());
+    Node<Type> *node = this->head;
+    while(node != nullptr){
+        Node<Type> *next = node->next;
+        delete node;
+        node = next;
+    }
+    this->head = this->tail = nullptr;
+    this->size = 0;
   }
 
   iterator begin()
   {
-    return iterator(*this, 0, head);
+    return iterator(*this, head);
   }
 
   iterator end()
   {
-    return iterator(*this, this->size, head);
+    return iterator(*this, nullptr);
   }
 
   const_iterator cbegin() const
   {
-    return const_iterator(*this, 0, head);
+    return const_iterator(*this, head);
   }
 
   const_iterator cend() const
   {
-    return const_iterator(*this, this->size, head);
+    return const_iterator(*this, nullptr);
   }
 
   const_iterator begin() const
@@ -250,15 +212,27 @@ public:
     Node<Type> *head, *tail;
     size_type size;
 
-    Node<Type>* getElementBefore(const const_iterator& possition){
-        if(possition.position > this->size) throw std::out_of_range("Getting element beyond a list");
+    //nullptr as 'next' appends
+    void linkBefore(Node<Type> *next, const Type& item){
+        Node<Type> *prev = next != nullptr ? next->prev : this->tail;
+        Node<Type> *node = new Node<Type>{item, next, prev};
+
+        if(prev != nullptr) prev->next = node;
+        else this->head = node;
+        if(next != nullptr) next->prev = node;
+        else this->tail = node;
 
-        if(possition.position == 0) return nullptr;
+        this->size++;
+    }
+
+    void unlink(Node<Type> *node){
+        if(node->prev != nullptr) node->prev->next = node->next;
+        else this->head = node->next;
+        if(node->next != nullptr) node->next->prev = node->prev;
+        else this->tail = node->prev;
 
-        Node<Type> *temp = this->head;
-        size_type i = 0;
-        while(i < possition.position-1) temp = temp->next, i++;
-        return temp;
+        delete node;
+        this->size--;
     }
 };
 
@@ -272,22 +246,26 @@ public:
   using pointer = typename LinkedList::const_pointer;
   using reference = typename LinkedList::const_reference;
 
-  explicit ConstIterator(const LinkedList<Type> &l, size_type pos, Node<Type> *h) : head(h), list(l), position(pos)  {}
+  //'n' is the node pointed at, nullptr for end()
+  explicit ConstIterator(const LinkedList<Type> &l, Node<Type> *n) : node(n), list(&l) {}
 
   reference operator*() const
   {
-    if(this->position >= list.getSize()) throw std::out_of_range("List exceeded when dereferencing");
+    if(this->node == nullptr) throw std::out_of_range("List exceeded when dereferencing");
 
-    Node<Type> *temp = this->head;
-    size_type i = 0;
-    while(i < this->position) temp = temp->next, i++;
-    return temp->value;
+    return this->node->value;
+  }
+
+  pointer operator->() const
+  {
+    return &this->operator*();
   }
 
   ConstIterator& operator++()
   {
-    this->position++;
-    if(list.getSize()+1 == this->position) throw std::out_of_range("List exceeded");
+    if(this->node == nullptr) throw std::out_of_range("List exceeded");
+
+    this->node = this->node->next;
 
     return *this;
   }
@@ -302,9 +280,10 @@ public:
 
   ConstIterator& operator--()
   {
-    if(!this->position) throw std::out_of_range("List exceeded");
+    Node<Type> *previous = this->node != nullptr ? this->node->prev : list->tail;
+    if(previous == nullptr) throw std::out_of_range("List exceeded");
 
-    this->position--;
+    this->node = previous;
 
     return *this;
   }
@@ -335,7 +314,7 @@ public:
 
   bool operator==(const ConstIterator& other) const
   {
-    return (this->head == other.head && this->position == other.position);
+    return (this->list == other.list && this->node == other.node);
   }
 
   bool operator!=(const ConstIterator& other) const
@@ -344,11 +323,10 @@ public:
   }
 
 protected:
-    Node<Type> *head;
-    const LinkedList<Type> &list;
+    friend class LinkedList;
 
-public:
-    size_type position;
+    Node<Type> *node;
+    const LinkedList<Type> *list;
 };
 
 template <typename Type>
@@ -358,7 +336,7 @@ public:
   using pointer = typename LinkedList::pointer;
   using reference = typename LinkedList::reference;
 
-  explicit Iterator(const LinkedList<Type> &l, size_type pos, Node<Type> *h) : ConstIterator(l, pos, h) {}
+  explicit Iterator(const LinkedList<Type> &l, Node<Type> *n) : ConstIterator(l, n) {}
 
   Iterator(const ConstIterator& other)
     : ConstIterator(other)
@@ -400,6 +378,11 @@ public:
     return ConstIterator::operator-(d);
   }
 
+  pointer operator->() const
+  {
+    return &this->operator*();
+  }
+
   reference operator*() const
   {
     // ugly cast, yet reduces code duplication.
@@ -0,0 +1,566 @@
+#ifndef AISDI_LINEAR_MAPPEDVECTOR_H
+#define AISDI_LINEAR_MAPPEDVECTOR_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#if !defined(__linux__)
+#error "MappedVector needs mmap and mremap"
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace aisdi
+{
+
+//vector of trivially copyable elements kept in a file mapped into memory, the
+//API follows Vector; the OS pages the elements in and out, so the vector may
+//exceed the RAM and reopening the file gives the elements back without reading them
+//
+//the file starts with a small header holding the size, followed by the elements;
+//it grows with ftruncate and mremap and is trimmed to the size when closed
+//changes reach the file when the OS writes the pages back, flush() and sync() force it
+template <typename Type>
+class MappedVector
+{
+  static_assert(std::is_trivially_copyable<Type>::value, "MappedVector keeps its elements as raw bytes");
+
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = Type;
+  using pointer = Type*;
+  using reference = Type&;
+  using const_pointer = const Type*;
+  using const_reference = const Type&;
+
+  class ConstIterator;
+  class Iterator;
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+
+  enum class Mode { OPEN_OR_CREATE, OPEN, CREATE };
+
+  //hints passed to madvise for the whole mapping
+  enum class Access { NORMAL, SEQUENTIAL, RANDOM, WILL_NEED };
+
+  //OPEN fails when the file doesn't exist, CREATE empties an existing one
+  explicit MappedVector(const std::string& path, Mode mode = Mode::OPEN_OR_CREATE)
+    : _fd(-1), _header(nullptr), _mappedBytes(0), _capacity(0), _access(Access::NORMAL)
+  {
+    int flags = O_RDWR | O_CLOEXEC;
+    if(mode == Mode::OPEN_OR_CREATE) flags |= O_CREAT;
+    if(mode == Mode::CREATE) flags |= O_CREAT | O_TRUNC;
+    _fd = ::open(path.c_str(), flags, 0644);
+    if(_fd < 0) throw std::system_error(errno, std::generic_category(), "Opening " + path);
+
+    try{
+        struct stat info;
+        if(::fstat(_fd, &info) != 0) throw std::system_error(errno, std::generic_category(), "Reading size of " + path);
+        size_type bytes = info.st_size;
+        if(bytes == 0){
+            resizeFile(HEADER_BYTES);
+            bytes = HEADER_BYTES;
+        }
+        if(bytes < HEADER_BYTES) throw std::runtime_error("Not a MappedVector file: " + path);
+
+        map(bytes);
+        _capacity = (bytes - HEADER_BYTES) / sizeof(Type);
+        if(info.st_size == 0){
+            std::memcpy(_header->magic, MAGIC, sizeof(MAGIC));
+            _header->elementSize = sizeof(Type);
+            _header->size = 0;
+        }
+        else if(std::memcmp(_header->magic, MAGIC, sizeof(MAGIC)) != 0 || _header->elementSize != sizeof(Type)
+                || _header->size > _capacity){
+            throw std::runtime_error("Not a MappedVector file of this element type: " + path);
+        }
+    }
+    catch(...){
+        close();
+        throw;
+    }
+  }
+
+  MappedVector(const MappedVector&) = delete;
+  MappedVector& operator=(const MappedVector&) = delete;
+
+  MappedVector(MappedVector&& other)
+    : _fd(other._fd), _header(other._header), _mappedBytes(other._mappedBytes),
+      _capacity(other._capacity), _access(other._access)
+  {
+    other._fd = -1;
+    other._header = nullptr;
+    other._mappedBytes = other._capacity = 0;
+  }
+
+  MappedVector& operator=(MappedVector&& other)
+  {
+    if(&other == this) return *this;
+
+    close();
+    _fd = other._fd, _header = other._header;
+    _mappedBytes = other._mappedBytes, _capacity = other._capacity;
+    _access = other._access;
+    other._fd = -1;
+    other._header = nullptr;
+    other._mappedBytes = other._capacity = 0;
+    return *this;
+  }
+
+  ~MappedVector()
+  {
+    close();
+  }
+
+  const Type& operator[](size_type index) const
+  {
+    return data()[index];
+  }
+
+  Type& operator[](size_type index)
+  {
+    return data()[index];
+  }
+
+  const Type* data() const
+  {
+    return reinterpret_cast<const_pointer>(reinterpret_cast<const char*>(_header) + HEADER_BYTES);
+  }
+
+  Type* data()
+  {
+    return reinterpret_cast<pointer>(reinterpret_cast<char*>(_header) + HEADER_BYTES);
+  }
+
+  bool isEmpty() const
+  {
+    return !getSize();
+  }
+
+  size_type getSize() const
+  {
+    return _header->size;
+  }
+
+  size_type capacity() const
+  {
+    return _capacity;
+  }
+
+  //extends the file so that it holds at least 'count' elements
+  void reserve(size_type count)
+  {
+    if(count > _capacity) reallocate(count);
+  }
+
+  //trims the file to the current size
+  void shrinkToFit()
+  {
+    if(getSize() < _capacity) reallocate(getSize());
+  }
+
+  void append(const Type& item)
+  {
+    emplaceBack(item);
+  }
+
+  template <typename... Args>
+  Type& emplaceBack(Args&&... args)
+  {
+    //args may refer to an element, which growing would move
+    Type item(std::forward<Args>(args)...);
+    size_type size = getSize();
+    if(size == _capacity) reallocate(grownSize());
+    new (data() + size) Type(item);
+    _header->size = size + 1;
+    return data()[size];
+  }
+
+  Type popLast()
+  {
+    if(isEmpty()) throw std::logic_error("Popping element when the vector is empty");
+    return data()[--_header->size];
+  }
+
+  //drops the elements, the file keeps its length until shrinkToFit() or closing
+  void clear()
+  {
+    _header->size = 0;
+  }
+
+  void advise(Access access)
+  {
+    _access = access;
+    applyAdvice();
+  }
+
+  //schedules writing the changed pages back to the file
+  void flush()
+  {
+    if(::msync(_header, _mappedBytes, MS_ASYNC) != 0) throw std::system_error(errno, std::generic_category(), "msync");
+  }
+
+  //returns once the elements and the file length are on the disk
+  void sync()
+  {
+    if(::msync(_header, _mappedBytes, MS_SYNC) != 0) throw std::system_error(errno, std::generic_category(), "msync");
+    if(::fsync(_fd) != 0) throw std::system_error(errno, std::generic_category(), "fsync");
+  }
+
+  iterator begin()
+  {
+    return iterator(*this, 0);
+  }
+
+  iterator end()
+  {
+    return iterator(*this, getSize());
+  }
+
+  const_iterator cbegin() const
+  {
+    return const_iterator(*this, 0);
+  }
+
+  const_iterator cend() const
+  {
+    return const_iterator(*this, getSize());
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+
+private:
+  static constexpr char MAGIC[8] = {'A', 'I', 'S', 'D', 'I', 'M', 'V', '1'};
+
+  struct Header{
+    char magic[8];
+    std::uint64_t elementSize;
+    std::uint64_t size;
+  };
+
+  //elements start at this offset, keeping them aligned
+  static constexpr size_type HEADER_BYTES = 64;
+  static_assert(sizeof(Header) <= HEADER_BYTES && alignof(Type) <= HEADER_BYTES, "Elements would overlap the header");
+
+  int _fd;
+  Header *_header;
+  size_type _mappedBytes;
+  size_type _capacity;
+  Access _access;
+
+  static size_type pageSize()
+  {
+    static const size_type size = sysconf(_SC_PAGESIZE);
+    return size;
+  }
+
+  static size_type pageRound(size_type bytes)
+  {
+    return (bytes + pageSize() - 1) / pageSize() * pageSize();
+  }
+
+  //doubles, but the first growth fills up the page holding the header
+  size_type grownSize() const
+  {
+    size_type firstPage = (pageSize() - HEADER_BYTES) / sizeof(Type);
+    size_type newCapacity = _capacity * 2;
+    if(newCapacity < firstPage) newCapacity = firstPage;
+    return newCapacity > _capacity ? newCapacity : _capacity + 1;
+  }
+
+  void resizeFile(size_type bytes)
+  {
+    if(::ftruncate(_fd, bytes) != 0) throw std::system_error(errno, std::generic_category(), "ftruncate");
+  }
+
+  void map(size_type bytes)
+  {
+    size_type length = pageRound(bytes);
+    void *p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if(p == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "mmap");
+    _header = static_cast<Header*>(p);
+    _mappedBytes = length;
+  }
+
+  void applyAdvice()
+  {
+    static const int advice[] = {MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED};
+    ::madvise(_header, _mappedBytes, advice[static_cast<int>(_access)]);
+  }
+
+  //sets the file length to hold newCapacity elements and remaps it, pages that
+  //stay mapped keep their address only if the kernel can extend the mapping in place
+  void reallocate(size_type newCapacity)
+  {
+    size_type bytes = HEADER_BYTES + newCapacity * sizeof(Type);
+    size_type length = pageRound(bytes);
+    if(bytes > HEADER_BYTES + _capacity * sizeof(Type)) resizeFile(bytes);
+    if(length != _mappedBytes){
+        void *p = ::mremap(_header, _mappedBytes, length, MREMAP_MAYMOVE);
+        if(p == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "mremap");
+        _header = static_cast<Header*>(p);
+        _mappedBytes = length;
+        if(_access != Access::NORMAL) applyAdvice();
+    }
+    if(bytes < HEADER_BYTES + _capacity * sizeof(Type)) resizeFile(bytes);
+    _capacity = newCapacity;
+  }
+
+  //trims the file to the elements in use and releases it
+  void close()
+  {
+    if(_header != nullptr){
+        size_type size = _header->size;
+        ::munmap(_header, _mappedBytes);
+        _header = nullptr;
+        //a destructor has nowhere to report a failure, the file then just stays longer
+        if(::ftruncate(_fd, HEADER_BYTES + size * sizeof(Type)) != 0) {}
+    }
+    if(_fd >= 0) ::close(_fd);
+    _fd = -1;
+  }
+};
+
+template <typename Type>
+constexpr char MappedVector<Type>::MAGIC[8];
+
+template <typename Type>
+class MappedVector<Type>::ConstIterator
+{
+protected:
+  const MappedVector *vec;
+
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename MappedVector::value_type;
+  using difference_type = typename MappedVector::difference_type;
+  using pointer = typename MappedVector::const_pointer;
+  using reference = typename MappedVector::const_reference;
+
+  size_t position;
+
+  ConstIterator() : vec(nullptr), position(0) {}
+
+  explicit ConstIterator(const MappedVector &v, size_t pos) : vec(&v), position(pos) {}
+
+  reference operator*() const
+  {
+    if(this->position == vec->getSize()) throw std::out_of_range("Tried to get value of end() element");
+    return (*vec)[position];
+  }
+
+  pointer operator->() const
+  {
+    return &this->operator*();
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return (*vec)[position + d];
+  }
+
+  ConstIterator& operator++()
+  {
+    if(++(this->position) > vec->getSize()) throw std::out_of_range("Array exceeded");
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator tmp = *this;
+    ++(*this);
+    return tmp;
+  }
+
+  ConstIterator& operator--()
+  {
+    if(this->position == 0) throw std::out_of_range("Array exceeded");
+    this->position--;
+    return *this;
+  }
+
+  ConstIterator operator--(int)
+  {
+    ConstIterator tmp = *this;
+    --(*this);
+    return tmp;
+  }
+
+  ConstIterator& operator+=(difference_type d)
+  {
+    difference_type target = static_cast<difference_type>(this->position) + d;
+    if(target < 0 || target > static_cast<difference_type>(vec->getSize())) throw std::out_of_range("Array exceeded");
+    this->position = target;
+    return *this;
+  }
+
+  ConstIterator& operator-=(difference_type d)
+  {
+    return *this += -d;
+  }
+
+  ConstIterator operator+(difference_type d) const
+  {
+    ConstIterator tmp = *this;
+    return tmp += d;
+  }
+
+  friend ConstIterator operator+(difference_type d, const ConstIterator& it)
+  {
+    return it + d;
+  }
+
+  ConstIterator operator-(difference_type d) const
+  {
+    ConstIterator tmp = *this;
+    return tmp -= d;
+  }
+
+  difference_type operator-(const ConstIterator& other) const
+  {
+    return static_cast<difference_type>(this->position) - static_cast<difference_type>(other.position);
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return this->position == other.position;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+
+  bool operator<(const ConstIterator& other) const
+  {
+    return this->position < other.position;
+  }
+
+  bool operator>(const ConstIterator& other) const
+  {
+    return other < *this;
+  }
+
+  bool operator<=(const ConstIterator& other) const
+  {
+    return !(other < *this);
+  }
+
+  bool operator>=(const ConstIterator& other) const
+  {
+    return !(*this < other);
+  }
+};
+
+template <typename Type>
+class MappedVector<Type>::Iterator : public MappedVector<Type>::ConstIterator
+{
+public:
+  using pointer = typename MappedVector::pointer;
+  using reference = typename MappedVector::reference;
+
+  Iterator()
+  {}
+
+  Iterator(const ConstIterator& other)
+    : ConstIterator(other)
+  {}
+
+  explicit Iterator(MappedVector &v, size_t pos) : ConstIterator(v, pos) {}
+
+  Iterator& operator++()
+  {
+    ConstIterator::operator++();
+    return *this;
+  }
+
+  Iterator operator++(int)
+  {
+    auto result = *this;
+    ConstIterator::operator++();
+    return result;
+  }
+
+  Iterator& operator--()
+  {
+    ConstIterator::operator--();
+    return *this;
+  }
+
+  Iterator operator--(int)
+  {
+    auto result = *this;
+    ConstIterator::operator--();
+    return result;
+  }
+
+  Iterator& operator+=(difference_type d)
+  {
+    ConstIterator::operator+=(d);
+    return *this;
+  }
+
+  Iterator& operator-=(difference_type d)
+  {
+    ConstIterator::operator-=(d);
+    return *this;
+  }
+
+  Iterator operator+(difference_type d) const
+  {
+    return ConstIterator::operator+(d);
+  }
+
+  friend Iterator operator+(difference_type d, const Iterator& it)
+  {
+    return it + d;
+  }
+
+  Iterator operator-(difference_type d) const
+  {
+    return ConstIterator::operator-(d);
+  }
+
+  using ConstIterator::operator-;
+
+  reference operator*() const
+  {
+    // ugly cast, yet reduces code duplication.
+    return const_cast<reference>(ConstIterator::operator*());
+  }
+
+  pointer operator->() const
+  {
+    return &this->operator*();
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return const_cast<reference>(ConstIterator::operator[](d));
+  }
+};
+
+}
+
+#endif /* AISDI_LINEAR_MAPPEDVECTOR_H */
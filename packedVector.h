@@ -0,0 +1,276 @@
+#ifndef AISDI_LINEAR_PACKEDVECTOR_H
+#define AISDI_LINEAR_PACKEDVECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+
+#include "vector.h"
+
+namespace aisdi
+{
+
+//vector of unsigned integers of Bits bits each, packed back to back into 64-bit words;
+//a value may straddle two words, so a read is at most two loads and a shift
+template <unsigned Bits>
+class PackedVector
+{
+  static_assert(Bits > 0 && Bits <= 64, "PackedVector holds 1 to 64 bit values");
+
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = std::uint64_t;
+
+  class ConstIterator;
+  using const_iterator = ConstIterator;
+
+  static constexpr value_type MAX_VALUE = Bits == 64 ? ~value_type(0) : (value_type(1) << Bits) - 1;
+
+  PackedVector() : _size(0) {}
+
+  value_type operator[](size_type index) const
+  {
+    size_type bit = index * Bits;
+    size_type word = bit / 64, offset = bit % 64;
+    value_type value = _words[word] >> offset;
+    if(offset + Bits > 64) value |= _words[word + 1] << (64 - offset);
+    return value & MAX_VALUE;
+  }
+
+  void set(size_type index, value_type value)
+  {
+    if(index >= _size) throw std::out_of_range("Setting beyond the end()");
+    if(value > MAX_VALUE) throw std::out_of_range("Value doesn't fit in the packed width");
+    write(index, value);
+  }
+
+  bool isEmpty() const
+  {
+    return !_size;
+  }
+
+  size_type getSize() const
+  {
+    return _size;
+  }
+
+  //bytes taken by the packed words
+  size_type getBytes() const
+  {
+    return _words.capacity() * sizeof(std::uint64_t);
+  }
+
+  void reserve(size_type count)
+  {
+    _words.reserve(wordsFor(count));
+  }
+
+  void append(value_type value)
+  {
+    if(value > MAX_VALUE) throw std::out_of_range("Value doesn't fit in the packed width");
+    while(_words.getSize() < wordsFor(_size + 1)) _words.append(0);
+    write(_size++, value);
+  }
+
+  value_type popLast()
+  {
+    if(isEmpty()) throw std::logic_error("Popping element when the vector is empty");
+
+    value_type value = (*this)[_size - 1];
+    write(_size - 1, 0);
+    --_size;
+    while(_words.getSize() > wordsFor(_size)) _words.popLast();
+    return value;
+  }
+
+  void clear()
+  {
+    _words.clear();
+    _size = 0;
+  }
+
+  bool operator==(const PackedVector& other) const
+  {
+    if(_size != other._size) return false;
+    //bits past the last value are kept zero, so whole words can be compared
+    for(size_type i = 0; i < _words.getSize(); ++i)
+        if(_words[i] != other._words[i]) return false;
+    return true;
+  }
+
+  bool operator!=(const PackedVector& other) const
+  {
+    return !(*this == other);
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator(*this, 0);
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator(*this, _size);
+  }
+
+  const_iterator cbegin() const
+  {
+    return begin();
+  }
+
+  const_iterator cend() const
+  {
+    return end();
+  }
+
+private:
+  Vector<std::uint64_t> _words;
+  size_type _size;
+
+  static size_type wordsFor(size_type count)
+  {
+    return (count * Bits + 63) / 64;
+  }
+
+  void write(size_type index, value_type value)
+  {
+    size_type bit = index * Bits;
+    size_type word = bit / 64, offset = bit % 64;
+    _words[word] = (_words[word] & ~(MAX_VALUE << offset)) | (value << offset);
+    if(offset + Bits > 64){
+        size_type spill = offset + Bits - 64;
+        value_type mask = (value_type(1) << spill) - 1;
+        _words[word + 1] = (_words[word + 1] & ~mask) | (value >> (64 - offset));
+    }
+  }
+};
+
+//values are decoded when dereferenced, there are no references to them
+template <unsigned Bits>
+class PackedVector<Bits>::ConstIterator
+{
+protected:
+  const PackedVector *vec;
+
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename PackedVector::value_type;
+  using difference_type = typename PackedVector::difference_type;
+  using pointer = void;
+  using reference = value_type;
+
+  size_t position;
+
+  ConstIterator() : vec(nullptr), position(0) {}
+
+  explicit ConstIterator(const PackedVector &v, size_t pos) : vec(&v), position(pos) {}
+
+  reference operator*() const
+  {
+    if(this->position == vec->getSize()) throw std::out_of_range("Tried to get value of end() element");
+    return (*vec)[position];
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return (*vec)[position + d];
+  }
+
+  ConstIterator& operator++()
+  {
+    if(++(this->position) > vec->getSize()) throw std::out_of_range("Array exceeded");
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator tmp = *this;
+    ++(*this);
+    return tmp;
+  }
+
+  ConstIterator& operator--()
+  {
+    if(this->position == 0) throw std::out_of_range("Array exceeded");
+    this->position--;
+    return *this;
+  }
+
+  ConstIterator operator--(int)
+  {
+    ConstIterator tmp = *this;
+    --(*this);
+    return tmp;
+  }
+
+  ConstIterator& operator+=(difference_type d)
+  {
+    difference_type target = static_cast<difference_type>(this->position) + d;
+    if(target < 0 || target > static_cast<difference_type>(vec->getSize())) throw std::out_of_range("Array exceeded");
+    this->position = target;
+    return *this;
+  }
+
+  ConstIterator& operator-=(difference_type d)
+  {
+    return *this += -d;
+  }
+
+  ConstIterator operator+(difference_type d) const
+  {
+    ConstIterator tmp = *this;
+    return tmp += d;
+  }
+
+  friend ConstIterator operator+(difference_type d, const ConstIterator& it)
+  {
+    return it + d;
+  }
+
+  ConstIterator operator-(difference_type d) const
+  {
+    ConstIterator tmp = *this;
+    return tmp -= d;
+  }
+
+  difference_type operator-(const ConstIterator& other) const
+  {
+    return static_cast<difference_type>(this->position) - static_cast<difference_type>(other.position);
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return this->position == other.position;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+
+  bool operator<(const ConstIterator& other) const
+  {
+    return this->position < other.position;
+  }
+
+  bool operator>(const ConstIterator& other) const
+  {
+    return other < *this;
+  }
+
+  bool operator<=(const ConstIterator& other) const
+  {
+    return !(other < *this);
+  }
+
+  bool operator>=(const ConstIterator& other) const
+  {
+    return !(*this < other);
+  }
+};
+
+}
+
+#endif /* AISDI_LINEAR_PACKEDVECTOR_H */
@@ -0,0 +1,341 @@
+#ifndef AISDI_LINEAR_PARALLELALGORITHMS_H
+#define AISDI_LINEAR_PARALLELALGORITHMS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "threadPool.h"
+#include "vector.h"
+
+namespace aisdi
+{
+
+//algorithms splitting a range into chunks of grain elements run as tasks of a ThreadPool
+//
+//grain 0 picks a chunk size from the number of threads, large enough to hide the
+//cost of a task; with deterministic set the chunks depend only on the size of the
+//range, so reduce and scan group their op calls the same way on every machine
+//(left to right within a chunk, then the chunk results left to right)
+struct ParallelOptions
+{
+  std::size_t grain = 0;
+  bool deterministic = false;
+  //nullptr stands for ThreadPool::instance()
+  ThreadPool *pool = nullptr;
+};
+
+namespace detail
+{
+
+//keeps the iterator overloads away from calls meant for the Vector ones
+template <typename It>
+using IteratorCategory = typename std::iterator_traits<It>::iterator_category;
+
+struct Chunking
+{
+  //smallest chunk worth a task when the grain is picked automatically
+  static constexpr std::size_t MIN_GRAIN = 4096;
+  static constexpr std::size_t DETERMINISTIC_GRAIN = 1 << 16;
+  //chunks per thread, the spare ones let idle threads steal
+  static constexpr std::size_t TASKS_PER_THREAD = 4;
+
+  ThreadPool &pool;
+  std::size_t size;
+  std::size_t grain;
+  std::size_t count;
+
+  Chunking(std::size_t n, const ParallelOptions& options)
+    : pool(options.pool != nullptr ? *options.pool : ThreadPool::instance()), size(n), grain(options.grain)
+  {
+    if(grain == 0 && options.deterministic) grain = DETERMINISTIC_GRAIN;
+    else if(grain == 0){
+        std::size_t tasks = pool.getConcurrency() * TASKS_PER_THREAD;
+        grain = std::max<std::size_t>(MIN_GRAIN, (n + tasks - 1) / tasks);
+    }
+    count = (n + grain - 1) / grain;
+  }
+
+  std::size_t begin(std::size_t chunk) const
+  {
+    return chunk * grain;
+  }
+
+  std::size_t end(std::size_t chunk) const
+  {
+    return std::min(size, (chunk + 1) * grain);
+  }
+
+  //f(chunk, begin, end) for every chunk
+  template <typename F>
+  void run(F&& f)
+  {
+    pool.run(count, [this, &f](std::size_t chunk){ f(chunk, begin(chunk), end(chunk)); });
+  }
+};
+
+//elements of a stable merge taken from a when the first d elements are output
+template <typename RandomIt, typename Compare>
+std::size_t mergeSplit(RandomIt a, std::size_t n, RandomIt b, std::size_t m, std::size_t d, Compare& compare)
+{
+  std::size_t low = d > m ? d - m : 0;
+  std::size_t high = std::min(d, n);
+  while(low < high){
+      std::size_t i = low + (high - low) / 2;
+      if(!compare(b[d - i - 1], a[i])) low = i + 1;
+      else high = i;
+  }
+  return low;
+}
+
+//uninitialized storage for the merge passes of parallelSort
+template <typename T>
+class MergeBuffer
+{
+public:
+  explicit MergeBuffer(std::size_t n)
+    : _data(static_cast<T*>(::operator new(n * sizeof(T)))), _constructed(0) {}
+
+  MergeBuffer(const MergeBuffer&) = delete;
+  MergeBuffer& operator=(const MergeBuffer&) = delete;
+
+  ~MergeBuffer()
+  {
+    for(std::size_t i = 0; i < _constructed; ++i) _data[i].~T();
+    ::operator delete(_data);
+  }
+
+  T* data() { return _data; }
+  void setConstructed(std::size_t n) { _constructed = n; }
+
+private:
+  T *_data;
+  std::size_t _constructed;
+};
+
+}
+
+//calls f(i, j) for consecutive index ranges [i, j) covering [0, count)
+template <typename F>
+void parallelFor(std::size_t count, F f, const ParallelOptions& options = ParallelOptions())
+{
+  detail::Chunking chunks(count, options);
+  chunks.run([&f](std::size_t, std::size_t b, std::size_t e){ f(b, e); });
+}
+
+template <typename RandomIt, typename F, typename = detail::IteratorCategory<RandomIt>>
+void parallelForEach(RandomIt first, RandomIt last, F f, const ParallelOptions& options = ParallelOptions())
+{
+  parallelFor(static_cast<std::size_t>(last - first), [first, &f](std::size_t b, std::size_t e){
+      for(std::size_t i = b; i < e; ++i) f(first[i]);
+  }, options);
+}
+
+template <typename Type, typename GrowthPolicy, typename F>
+void parallelForEach(Vector<Type, GrowthPolicy>& v, F f, const ParallelOptions& options = ParallelOptions())
+{
+  parallelForEach(v.data(), v.data() + v.getSize(), f, options);
+}
+
+template <typename Type, typename GrowthPolicy, typename F>
+void parallelForEach(const Vector<Type, GrowthPolicy>& v, F f, const ParallelOptions& options = ParallelOptions())
+{
+  parallelForEach(v.data(), v.data() + v.getSize(), f, options);
+}
+
+//out[i] = f(first[i]), the output range must hold last - first elements
+template <typename InputIt, typename OutputIt, typename F, typename = detail::IteratorCategory<InputIt>>
+void parallelTransform(InputIt first, InputIt last, OutputIt out, F f, const ParallelOptions& options = ParallelOptions())
+{
+  parallelFor(static_cast<std::size_t>(last - first), [first, out, &f](std::size_t b, std::size_t e){
+      for(std::size_t i = b; i < e; ++i) out[i] = f(first[i]);
+  }, options);
+}
+
+//out ends up with as many elements as in, missing ones are value-initialized beforehand
+template <typename Type, typename GrowthPolicy, typename Result, typename ResultGrowth, typename F>
+void parallelTransform(const Vector<Type, GrowthPolicy>& in, Vector<Result, ResultGrowth>& out, F f,
+                       const ParallelOptions& options = ParallelOptions())
+{
+  out.reserve(in.getSize());
+  while(out.getSize() > in.getSize()) out.popLast();
+  while(out.getSize() < in.getSize()) out.emplaceBack();
+  parallelTransform(in.data(), in.data() + in.getSize(), out.data(), f, options);
+}
+
+//init op first[0] op first[1] ... grouped by chunks, op has to be associative
+template <typename RandomIt, typename T, typename BinaryOp, typename = detail::IteratorCategory<RandomIt>>
+T parallelReduce(RandomIt first, RandomIt last, T init, BinaryOp op, const ParallelOptions& options = ParallelOptions())
+{
+  detail::Chunking chunks(static_cast<std::size_t>(last - first), options);
+  std::vector<std::optional<T>> partial(chunks.count);
+  chunks.run([first, &op, &partial](std::size_t chunk, std::size_t b, std::size_t e){
+      T acc = first[b];
+      for(std::size_t i = b + 1; i < e; ++i) acc = op(std::move(acc), first[i]);
+      partial[chunk].emplace(std::move(acc));
+  });
+  for(auto &p : partial) init = op(std::move(init), std::move(*p));
+  return init;
+}
+
+template <typename RandomIt, typename T, typename = detail::IteratorCategory<RandomIt>>
+T parallelReduce(RandomIt first, RandomIt last, T init)
+{
+  return parallelReduce(first, last, std::move(init), std::plus<T>());
+}
+
+template <typename Type, typename GrowthPolicy, typename T, typename BinaryOp>
+T parallelReduce(const Vector<Type, GrowthPolicy>& v, T init, BinaryOp op, const ParallelOptions& options = ParallelOptions())
+{
+  return parallelReduce(v.data(), v.data() + v.getSize(), std::move(init), op, options);
+}
+
+template <typename Type, typename GrowthPolicy, typename T>
+T parallelReduce(const Vector<Type, GrowthPolicy>& v, T init)
+{
+  return parallelReduce(v.data(), v.data() + v.getSize(), std::move(init), std::plus<T>());
+}
+
+//out[i] = first[0] op ... op first[i], out may be first itself
+//two passes: chunk totals, then every chunk is scanned again starting from the total of its predecessors
+template <typename RandomIt, typename OutputIt, typename BinaryOp, typename = detail::IteratorCategory<RandomIt>>
+void parallelInclusiveScan(RandomIt first, RandomIt last, OutputIt out, BinaryOp op,
+                           const ParallelOptions& options = ParallelOptions())
+{
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+
+  detail::Chunking chunks(static_cast<std::size_t>(last - first), options);
+  if(chunks.count == 0) return;
+  if(chunks.count == 1){
+      T acc = first[0];
+      out[0] = acc;
+      for(std::size_t i = 1; i < chunks.size; ++i){
+          acc = op(std::move(acc), first[i]);
+          out[i] = acc;
+      }
+      return;
+  }
+
+  std::vector<std::optional<T>> carry(chunks.count);
+  chunks.run([first, &op, &carry, &chunks](std::size_t chunk, std::size_t b, std::size_t e){
+      if(chunk + 1 == chunks.count) return;
+      T acc = first[b];
+      for(std::size_t i = b + 1; i < e; ++i) acc = op(std::move(acc), first[i]);
+      carry[chunk + 1].emplace(std::move(acc));
+  });
+  for(std::size_t chunk = 2; chunk < chunks.count; ++chunk)
+      carry[chunk] = op(*carry[chunk - 1], std::move(*carry[chunk]));
+
+  chunks.run([first, out, &op, &carry](std::size_t chunk, std::size_t b, std::size_t e){
+      T acc = chunk == 0 ? T(first[b]) : op(*carry[chunk], first[b]);
+      out[b] = acc;
+      for(std::size_t i = b + 1; i < e; ++i){
+          acc = op(std::move(acc), first[i]);
+          out[i] = acc;
+      }
+  });
+}
+
+template <typename RandomIt, typename OutputIt, typename = detail::IteratorCategory<RandomIt>>
+void parallelInclusiveScan(RandomIt first, RandomIt last, OutputIt out)
+{
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+  parallelInclusiveScan(first, last, out, std::plus<T>());
+}
+
+//out ends up with as many elements as in, missing ones are value-initialized beforehand;
+//out may be in itself
+template <typename Type, typename GrowthPolicy, typename ResultGrowth, typename BinaryOp = std::plus<Type>>
+void parallelInclusiveScan(const Vector<Type, GrowthPolicy>& in, Vector<Type, ResultGrowth>& out, BinaryOp op = BinaryOp(),
+                           const ParallelOptions& options = ParallelOptions())
+{
+  out.reserve(in.getSize());
+  while(out.getSize() > in.getSize()) out.popLast();
+  while(out.getSize() < in.getSize()) out.emplaceBack();
+  parallelInclusiveScan(in.data(), in.data() + in.getSize(), out.data(), op, options);
+}
+
+//sorts chunks with std::sort, then merges them pairwise, each merge being split
+//among all threads along the merge path; not stable
+template <typename T, typename Compare = std::less<T>>
+void parallelSort(T *first, T *last, Compare compare = Compare(), const ParallelOptions& options = ParallelOptions())
+{
+  const std::size_t n = static_cast<std::size_t>(last - first);
+  ThreadPool &pool = options.pool != nullptr ? *options.pool : ThreadPool::instance();
+  std::size_t grain = options.grain != 0 ? options.grain : detail::Chunking::MIN_GRAIN;
+
+  //a power of two of runs, so that every merge round pairs all of them
+  std::size_t runs = 1;
+  while(runs < pool.getConcurrency() && n / (runs * 2) >= grain) runs *= 2;
+  if(runs == 1){
+      std::sort(first, last, compare);
+      return;
+  }
+  auto bound = [n, runs](std::size_t run){ return n / runs * run + std::min(run, n % runs); };
+
+  pool.run(runs, [&](std::size_t run){ std::sort(first + bound(run), first + bound(run + 1), compare); });
+
+  detail::MergeBuffer<T> buffer(n);
+  parallelFor(n, [first, &buffer](std::size_t b, std::size_t e){
+      std::uninitialized_copy(std::make_move_iterator(first + b), std::make_move_iterator(first + e), buffer.data() + b);
+  }, options);
+  buffer.setConstructed(n);
+
+  T *from = buffer.data();
+  T *to = first;
+  const std::size_t pieces = pool.getConcurrency() * detail::Chunking::TASKS_PER_THREAD;
+  std::vector<std::size_t> splits;
+  for(std::size_t width = 1; width < runs; width *= 2){
+      std::size_t pairs = runs / (2 * width);
+      std::size_t perPair = std::max<std::size_t>(1, pieces / pairs);
+      auto low = [&](std::size_t pair){ return bound(2 * pair * width); };
+      auto middle = [&](std::size_t pair){ return bound((2 * pair + 1) * width); };
+      auto high = [&](std::size_t pair){ return bound((2 * pair + 2) * width); };
+      auto diagonal = [&](std::size_t pair, std::size_t piece){ return (high(pair) - low(pair)) * piece / perPair; };
+
+      //all the split points are found before any merge moves elements out of the runs
+      splits.assign(pairs * (perPair + 1), 0);
+      pool.run(pairs * (perPair + 1), [&](std::size_t task){
+          std::size_t pair = task / (perPair + 1);
+          std::size_t piece = task % (perPair + 1);
+          splits[task] = detail::mergeSplit(from + low(pair), middle(pair) - low(pair), from + middle(pair),
+                                            high(pair) - middle(pair), diagonal(pair, piece), compare);
+      });
+      pool.run(pairs * perPair, [&](std::size_t task){
+          std::size_t pair = task / perPair;
+          std::size_t piece = task % perPair;
+          std::size_t d1 = diagonal(pair, piece);
+          std::size_t d2 = diagonal(pair, piece + 1);
+          std::size_t i1 = splits[pair * (perPair + 1) + piece];
+          std::size_t i2 = splits[pair * (perPair + 1) + piece + 1];
+          T *a = from + low(pair);
+          T *b = from + middle(pair);
+          std::merge(std::make_move_iterator(a + i1), std::make_move_iterator(a + i2),
+                     std::make_move_iterator(b + (d1 - i1)), std::make_move_iterator(b + (d2 - i2)),
+                     to + low(pair) + d1, compare);
+      });
+      std::swap(from, to);
+  }
+
+  if(from != first){
+      parallelFor(n, [from, first](std::size_t b, std::size_t e){
+          std::move(from + b, from + e, first + b);
+      }, options);
+  }
+}
+
+template <typename Type, typename GrowthPolicy, typename Compare = std::less<Type>>
+void parallelSort(Vector<Type, GrowthPolicy>& v, Compare compare = Compare(), const ParallelOptions& options = ParallelOptions())
+{
+  parallelSort(v.data(), v.data() + v.getSize(), compare, options);
+}
+
+}
+
+#endif /* AISDI_LINEAR_PARALLELALGORITHMS_H */
@@ -0,0 +1,408 @@
+#ifndef AISDI_LINEAR_PRIORITYQUEUE_H
+#define AISDI_LINEAR_PRIORITYQUEUE_H
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include "vector.h"
+
+namespace aisdi
+{
+
+//d-ary heap kept in a Vector, the top is the element every other one is less than
+//according to Compare (the greatest with std::less, the smallest with std::greater)
+//with Arity 4 a sift down compares the children sitting in one or two cache lines
+//and the heap is half as deep as a binary one
+template <typename Type, typename Compare = std::less<Type>, std::size_t Arity = 4>
+class PriorityQueue
+{
+  static_assert(Arity >= 2, "PriorityQueue needs at least two children per node");
+
+public:
+  using size_type = std::size_t;
+  using value_type = Type;
+  using reference = Type&;
+  using const_reference = const Type&;
+
+  explicit PriorityQueue(const Compare& compare = Compare()) : _compare(compare) {}
+
+  PriorityQueue(std::initializer_list<Type> l, const Compare& compare = Compare()) : _compare(compare)
+  {
+    heapify(l.begin(), l.end());
+  }
+
+  template <typename InputIt>
+  PriorityQueue(InputIt first, InputIt last, const Compare& compare = Compare()) : _compare(compare)
+  {
+    heapify(first, last);
+  }
+
+  bool isEmpty() const
+  {
+    return _heap.isEmpty();
+  }
+
+  size_type getSize() const
+  {
+    return _heap.getSize();
+  }
+
+  void reserve(size_type count)
+  {
+    _heap.reserve(count);
+  }
+
+  const Type& top() const
+  {
+    if(isEmpty()) throw std::logic_error("Reading the top of an empty queue");
+    return _heap[0];
+  }
+
+  void push(const Type& item)
+  {
+    emplace(item);
+  }
+
+  void push(Type&& item)
+  {
+    emplace(std::move(item));
+  }
+
+  template <typename... Args>
+  void emplace(Args&&... args)
+  {
+    _heap.emplaceBack(std::forward<Args>(args)...);
+    siftUp(_heap.getSize() - 1);
+  }
+
+  Type pop()
+  {
+    if(isEmpty()) throw std::logic_error("Popping element when the queue is empty");
+
+    Type value = std::move(_heap[0]);
+    Type last = _heap.popLast();
+    if(!isEmpty()){
+        _heap[0] = std::move(last);
+        siftDown(0);
+    }
+    return value;
+  }
+
+  //pops the top and pushes the item in one sift down, returns the old top
+  Type replaceTop(Type item)
+  {
+    if(isEmpty()) throw std::logic_error("Replacing the top of an empty queue");
+
+    Type value = std::move(_heap[0]);
+    _heap[0] = std::move(item);
+    siftDown(0);
+    return value;
+  }
+
+  //replaces the contents with the range, ordered bottom-up in O(n)
+  template <typename InputIt>
+  void heapify(InputIt first, InputIt last)
+  {
+    _heap.assign(first, last);
+    size_type size = _heap.getSize();
+    if(size < 2) return;
+    for(size_type i = (size - 2) / Arity + 1; i-- > 0; ) siftDown(i);
+  }
+
+  void clear()
+  {
+    _heap.clear();
+  }
+
+  //the elements in heap order
+  const Type* data() const
+  {
+    return _heap.data();
+  }
+
+private:
+  Vector<Type> _heap;
+  Compare _compare;
+
+  //the element is moved out and the ones in its way are shifted into the hole
+  void siftUp(size_type index)
+  {
+    Type item = std::move(_heap[index]);
+    while(index > 0){
+        size_type parent = (index - 1) / Arity;
+        if(!_compare(_heap[parent], item)) break;
+        _heap[index] = std::move(_heap[parent]);
+        index = parent;
+    }
+    _heap[index] = std::move(item);
+  }
+
+  void siftDown(size_type index)
+  {
+    size_type size = _heap.getSize();
+    Type item = std::move(_heap[index]);
+    for(;;){
+        size_type first = index * Arity + 1;
+        if(first >= size) break;
+        size_type last = first + Arity < size ? first + Arity : size;
+        size_type best = first;
+        for(size_type child = first + 1; child < last; ++child)
+            if(_compare(_heap[best], _heap[child])) best = child;
+        if(!_compare(item, _heap[best])) break;
+        _heap[index] = std::move(_heap[best]);
+        index = best;
+    }
+    _heap[index] = std::move(item);
+  }
+};
+
+//PriorityQueue whose elements can be reached after they are pushed: push() returns
+//a handle that stays valid until the element is popped or erased, so its priority can
+//be changed or the element removed in O(log n) (what Dijkstra's or a scheduler need)
+//handles of removed elements are reused
+template <typename Type, typename Compare = std::less<Type>, std::size_t Arity = 4>
+class IndexedPriorityQueue
+{
+  static_assert(Arity >= 2, "IndexedPriorityQueue needs at least two children per node");
+
+public:
+  using size_type = std::size_t;
+  using value_type = Type;
+  using reference = Type&;
+  using const_reference = const Type&;
+  using handle_type = std::size_t;
+
+  explicit IndexedPriorityQueue(const Compare& compare = Compare()) : _compare(compare) {}
+
+  bool isEmpty() const
+  {
+    return _heap.isEmpty();
+  }
+
+  size_type getSize() const
+  {
+    return _heap.getSize();
+  }
+
+  void reserve(size_type count)
+  {
+    _heap.reserve(count);
+    _positions.reserve(count);
+  }
+
+  const Type& top() const
+  {
+    if(isEmpty()) throw std::logic_error("Reading the top of an empty queue");
+    return _heap[0].value;
+  }
+
+  handle_type topHandle() const
+  {
+    if(isEmpty()) throw std::logic_error("Reading the top of an empty queue");
+    return _heap[0].handle;
+  }
+
+  handle_type push(const Type& item)
+  {
+    return emplace(item);
+  }
+
+  handle_type push(Type&& item)
+  {
+    return emplace(std::move(item));
+  }
+
+  template <typename... Args>
+  handle_type emplace(Args&&... args)
+  {
+    //the handle is taken off the free list only once the element is in
+    if(_free.isEmpty()){
+        _positions.append(NONE);
+        _free.append(_positions.getSize() - 1);
+    }
+    handle_type handle = _free[_free.getSize() - 1];
+    _heap.emplaceBack(handle, std::forward<Args>(args)...);
+    _free.popLast();
+    siftUp(_heap.getSize() - 1);
+    return handle;
+  }
+
+  Type pop()
+  {
+    if(isEmpty()) throw std::logic_error("Popping element when the queue is empty");
+    return removeAt(0);
+  }
+
+  bool contains(handle_type handle) const
+  {
+    return handle < _positions.getSize() && _positions[handle] != NONE;
+  }
+
+  const Type& valueOf(handle_type handle) const
+  {
+    return _heap[positionOf(handle)].value;
+  }
+
+  //sets a new value and moves the element up or down as needed
+  void update(handle_type handle, Type value)
+  {
+    size_type index = positionOf(handle);
+    bool up = _compare(_heap[index].value, value);
+    _heap[index].value = std::move(value);
+    if(up) siftUp(index);
+    else siftDown(index);
+  }
+
+  //moves the element towards the top, the value may not be lower than the current one
+  //(with std::greater, a min-queue, that is a decrease of the key)
+  void decreaseKey(handle_type handle, Type value)
+  {
+    size_type index = positionOf(handle);
+    if(_compare(value, _heap[index].value)) throw std::logic_error("decreaseKey would move the element away from the top");
+    _heap[index].value = std::move(value);
+    siftUp(index);
+  }
+
+  Type erase(handle_type handle)
+  {
+    return removeAt(positionOf(handle));
+  }
+
+  void clear()
+  {
+    _heap.clear();
+    _positions.clear();
+    _free.clear();
+  }
+
+private:
+  static constexpr size_type NONE = static_cast<size_type>(-1);
+
+  struct Node{
+    handle_type handle;
+    Type value;
+
+    template <typename... Args>
+    explicit Node(handle_type h, Args&&... args) : handle(h), value(std::forward<Args>(args)...) {}
+  };
+
+  Vector<Node> _heap;
+  //heap index of every handle, NONE for the free ones
+  Vector<size_type> _positions;
+  Vector<handle_type> _free;
+  Compare _compare;
+
+  size_type positionOf(handle_type handle) const
+  {
+    if(!contains(handle)) throw std::out_of_range("No element with the handle");
+    return _positions[handle];
+  }
+
+  void place(size_type index, Node&& node)
+  {
+    _positions[node.handle] = index;
+    _heap[index] = std::move(node);
+  }
+
+  Type removeAt(size_type index)
+  {
+    handle_type handle = _heap[index].handle;
+    Type value = std::move(_heap[index].value);
+    Node last = _heap.popLast();
+    if(index < _heap.getSize()){
+        bool up = _compare(value, last.value);
+        place(index, std::move(last));
+        if(up) siftUp(index);
+        else siftDown(index);
+    }
+    _positions[handle] = NONE;
+    _free.append(handle);
+    return value;
+  }
+
+  void siftUp(size_type index)
+  {
+    Node item = std::move(_heap[index]);
+    while(index > 0){
+        size_type parent = (index - 1) / Arity;
+        if(!_compare(_heap[parent].value, item.value)) break;
+        place(index, std::move(_heap[parent]));
+        index = parent;
+    }
+    place(index, std::move(item));
+  }
+
+  void siftDown(size_type index)
+  {
+    size_type size = _heap.getSize();
+    Node item = std::move(_heap[index]);
+    for(;;){
+        size_type first = index * Arity + 1;
+        if(first >= size) break;
+        size_type last = first + Arity < size ? first + Arity : size;
+        size_type best = first;
+        for(size_type child = first + 1; child < last; ++child)
+            if(_compare(_heap[best].value, _heap[child].value)) best = child;
+        if(!_compare(item.value, _heap[best].value)) break;
+        place(index, std::move(_heap[best]));
+        index = best;
+    }
+    place(index, std::move(item));
+  }
+};
+
+namespace detail
+{
+
+template <typename Compare>
+struct ReverseCompare
+{
+  Compare compare;
+
+  template <typename T>
+  bool operator()(const T& a, const T& b) const
+  {
+    return compare(b, a);
+  }
+};
+
+}
+
+//the k greatest elements of the range according to compare (the k smallest with
+//std::greater), best first; one pass keeping the k best in a heap, O(n log k)
+template <typename InputIt, typename Compare = std::less<typename std::iterator_traits<InputIt>::value_type>>
+Vector<typename std::iterator_traits<InputIt>::value_type> topK(InputIt first, InputIt last, std::size_t k, Compare compare = Compare())
+{
+  using Value = typename std::iterator_traits<InputIt>::value_type;
+
+  //the top of the kept ones is the worst of them, the one to drop
+  PriorityQueue<Value, detail::ReverseCompare<Compare>> kept(detail::ReverseCompare<Compare>{compare});
+  Vector<Value> result;
+  if(k == 0) return result;
+
+  kept.reserve(k);
+  for(; first != last; ++first){
+      if(kept.getSize() < k) kept.push(*first);
+      else if(compare(kept.top(), *first)) kept.replaceTop(*first);
+  }
+
+  //popped worst first
+  result.reserve(kept.getSize());
+  while(!kept.isEmpty()) result.append(kept.pop());
+  for(std::size_t i = 0, j = result.getSize(); i + 1 < j; ++i, --j) std::swap(result[i], result[j - 1]);
+  return result;
+}
+
+template <typename Range, typename Compare = std::less<typename Range::value_type>>
+Vector<typename Range::value_type> topK(const Range& range, std::size_t k, Compare compare = Compare())
+{
+  return topK(range.begin(), range.end(), k, compare);
+}
+
+}
+
+#endif /* AISDI_LINEAR_PRIORITYQUEUE_H */
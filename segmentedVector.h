@@ -0,0 +1,518 @@
+#ifndef AISDI_LINEAR_SEGMENTEDVECTOR_H
+#define AISDI_LINEAR_SEGMENTEDVECTOR_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace aisdi
+{
+
+//vector made of blocks that are never moved: block k holds FirstBlock << k elements,
+//so growing only allocates the next block, addresses of elements stay valid until
+//they are removed and an index needs a bit scan to find the block
+//the API follows Vector, with no insertion or removal other than at the end
+template <typename Type, std::size_t FirstBlock = 16>
+class SegmentedVector
+{
+  static_assert(FirstBlock > 0 && (FirstBlock & (FirstBlock - 1)) == 0, "FirstBlock has to be a power of two");
+
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = Type;
+  using pointer = Type*;
+  using reference = Type&;
+  using const_pointer = const Type*;
+  using const_reference = const Type&;
+
+  class ConstIterator;
+  class Iterator;
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+
+  SegmentedVector() : _blocks(), _blockCount(0), _size(0) {}
+
+  SegmentedVector(std::initializer_list<Type> l) : SegmentedVector()
+  {
+    reserve(l.size());
+    for(auto &i : l) append(i);
+  }
+
+  SegmentedVector(const SegmentedVector& other) : SegmentedVector()
+  {
+    reserve(other._size);
+    for(size_type i = 0; i < other._size; ++i) append(other[i]);
+  }
+
+  SegmentedVector(SegmentedVector&& other) noexcept : SegmentedVector()
+  {
+    takeFrom(other);
+  }
+
+  ~SegmentedVector()
+  {
+    clear();
+    releaseBlocks(0);
+  }
+
+  SegmentedVector& operator=(const SegmentedVector& other)
+  {
+    if(&other == this) return *this;
+
+    clear();
+    reserve(other._size);
+    for(size_type i = 0; i < other._size; ++i) append(other[i]);
+    return *this;
+  }
+
+  SegmentedVector& operator=(SegmentedVector&& other) noexcept
+  {
+    if(&other == this) return *this;
+
+    clear();
+    releaseBlocks(0);
+    takeFrom(other);
+    return *this;
+  }
+
+  const Type& operator[](size_type index) const
+  {
+    size_type block = blockOf(index);
+    return _blocks[block][index + FirstBlock - (FirstBlock << block)];
+  }
+
+  Type& operator[](size_type index)
+  {
+    size_type block = blockOf(index);
+    return _blocks[block][index + FirstBlock - (FirstBlock << block)];
+  }
+
+  bool isEmpty() const
+  {
+    return !_size;
+  }
+
+  size_type getSize() const
+  {
+    return _size;
+  }
+
+  size_type capacity() const
+  {
+    return blockStart(_blockCount);
+  }
+
+  //allocates the blocks needed to hold 'count' elements
+  void reserve(size_type count)
+  {
+    while(capacity() < count) addBlock();
+  }
+
+  //frees the blocks holding no elements
+  void shrinkToFit()
+  {
+    releaseBlocks(usedBlocks());
+  }
+
+  void append(const Type& item)
+  {
+    emplaceBack(item);
+  }
+
+  void append(Type&& item)
+  {
+    emplaceBack(std::move(item));
+  }
+
+  //nothing moves when a block is added, so args may refer to an element
+  template <typename... Args>
+  Type& emplaceBack(Args&&... args)
+  {
+    if(_size == capacity()) addBlock();
+    Type *slot = &(*this)[_size];
+    new (slot) Type(std::forward<Args>(args)...);
+    ++_size;
+    return *slot;
+  }
+
+  //a block left empty is kept as a spare for the next appends, the one above it is freed
+  Type popLast()
+  {
+    if(isEmpty()) throw std::logic_error("Popping element when the vector is empty");
+
+    Type &last = (*this)[_size-1];
+    Type value = std::move(last);
+    last.~Type();
+    --_size;
+    if(_blockCount > usedBlocks() + 1) releaseBlocks(usedBlocks() + 1);
+    return value;
+  }
+
+  //drops the elements, the blocks are kept
+  void clear()
+  {
+    for(size_type i = 0; i < _size; ++i) (*this)[i].~Type();
+    _size = 0;
+  }
+
+  //blocks with elements in use, block k starts with element (FirstBlock << k) - FirstBlock
+  size_type blockCount() const
+  {
+    return usedBlocks();
+  }
+
+  const Type* blockData(size_type block) const
+  {
+    return _blocks[block];
+  }
+
+  Type* blockData(size_type block)
+  {
+    return _blocks[block];
+  }
+
+  //elements in use in the block
+  size_type blockSize(size_type block) const
+  {
+    size_type end = blockStart(block + 1) < _size ? blockStart(block + 1) : _size;
+    return end - blockStart(block);
+  }
+
+  //f(data, count) for every block in order, the loop over a block is a plain array walk
+  template <typename F>
+  void forEachBlock(F f)
+  {
+    for(size_type block = 0; block < usedBlocks(); ++block) f(_blocks[block], blockSize(block));
+  }
+
+  template <typename F>
+  void forEachBlock(F f) const
+  {
+    for(size_type block = 0; block < usedBlocks(); ++block) f(static_cast<const_pointer>(_blocks[block]), blockSize(block));
+  }
+
+  bool operator==(const SegmentedVector& other) const
+  {
+    if(_size != other._size) return false;
+    for(size_type i = 0; i < _size; ++i)
+        if((*this)[i] != other[i]) return false;
+    return true;
+  }
+
+  bool operator!=(const SegmentedVector& other) const
+  {
+    return !(*this == other);
+  }
+
+  iterator begin()
+  {
+    return iterator(*this, 0);
+  }
+
+  iterator end()
+  {
+    return iterator(*this, _size);
+  }
+
+  const_iterator cbegin() const
+  {
+    return const_iterator(*this, 0);
+  }
+
+  const_iterator cend() const
+  {
+    return const_iterator(*this, _size);
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+
+private:
+  static constexpr size_type FIRST_SHIFT = __builtin_ctzll(FirstBlock);
+  //enough blocks to address every size_type index
+  static constexpr size_type MAX_BLOCKS = sizeof(size_type) * 8 - FIRST_SHIFT;
+
+  pointer _blocks[MAX_BLOCKS];
+  size_type _blockCount;
+  size_type _size;
+
+  static size_type blockOf(size_type index)
+  {
+    return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(index + FirstBlock) - FIRST_SHIFT;
+  }
+
+  static size_type blockStart(size_type block)
+  {
+    return (FirstBlock << block) - FirstBlock;
+  }
+
+  size_type usedBlocks() const
+  {
+    return _size ? blockOf(_size - 1) + 1 : 0;
+  }
+
+  void addBlock()
+  {
+    if(_blockCount == MAX_BLOCKS) throw std::length_error("SegmentedVector is full");
+
+    size_type count = FirstBlock << _blockCount;
+    if(alignof(Type) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        _blocks[_blockCount] = static_cast<pointer>(::operator new(count * sizeof(Type), std::align_val_t(alignof(Type))));
+    else _blocks[_blockCount] = static_cast<pointer>(::operator new(count * sizeof(Type)));
+    ++_blockCount;
+  }
+
+  //frees the blocks from 'first' on, they must hold no elements
+  void releaseBlocks(size_type first)
+  {
+    for(; _blockCount > first; --_blockCount){
+        if(alignof(Type) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) ::operator delete(_blocks[_blockCount-1], std::align_val_t(alignof(Type)));
+        else ::operator delete(_blocks[_blockCount-1]);
+        _blocks[_blockCount-1] = nullptr;
+    }
+  }
+
+  //expects this vector to hold no blocks, the ones of other are taken over
+  void takeFrom(SegmentedVector &other)
+  {
+    for(size_type i = 0; i < other._blockCount; ++i){
+        _blocks[i] = other._blocks[i];
+        other._blocks[i] = nullptr;
+    }
+    _blockCount = other._blockCount;
+    _size = other._size;
+    other._blockCount = 0;
+    other._size = 0;
+  }
+};
+
+template <typename Type, std::size_t FirstBlock>
+class SegmentedVector<Type, FirstBlock>::ConstIterator
+{
+protected:
+  const SegmentedVector *vec;
+
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename SegmentedVector::value_type;
+  using difference_type = typename SegmentedVector::difference_type;
+  using pointer = typename SegmentedVector::const_pointer;
+  using reference = typename SegmentedVector::const_reference;
+
+  size_t position;
+
+  ConstIterator() : vec(nullptr), position(0) {}
+
+  explicit ConstIterator(const SegmentedVector &v, size_t pos) : vec(&v), position(pos) {}
+
+  reference operator*() const
+  {
+    if(this->position == vec->getSize()) throw std::out_of_range("Tried to get value of end() element");
+    return (*vec)[position];
+  }
+
+  pointer operator->() const
+  {
+    return &this->operator*();
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return (*vec)[position + d];
+  }
+
+  ConstIterator& operator++()
+  {
+    if(++(this->position) > vec->getSize()) throw std::out_of_range("Array exceeded");
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator tmp = *this;
+    ++(*this);
+    return tmp;
+  }
+
+  ConstIterator& operator--()
+  {
+    if(this->position == 0) throw std::out_of_range("Array exceeded");
+    this->position--;
+    return *this;
+  }
+
+  ConstIterator operator--(int)
+  {
+    ConstIterator tmp = *this;
+    --(*this);
+    return tmp;
+  }
+
+  ConstIterator& operator+=(difference_type d)
+  {
+    difference_type target = static_cast<difference_type>(this->position) + d;
+    if(target < 0 || target > static_cast<difference_type>(vec->getSize())) throw std::out_of_range("Array exceeded");
+    this->position = target;
+    return *this;
+  }
+
+  ConstIterator& operator-=(difference_type d)
+  {
+    return *this += -d;
+  }
+
+  ConstIterator operator+(difference_type d) const
+  {
+    ConstIterator tmp = *this;
+    return tmp += d;
+  }
+
+  friend ConstIterator operator+(difference_type d, const ConstIterator& it)
+  {
+    return it + d;
+  }
+
+  ConstIterator operator-(difference_type d) const
+  {
+    ConstIterator tmp = *this;
+    return tmp -= d;
+  }
+
+  difference_type operator-(const ConstIterator& other) const
+  {
+    return static_cast<difference_type>(this->position) - static_cast<difference_type>(other.position);
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return this->position == other.position;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+
+  bool operator<(const ConstIterator& other) const
+  {
+    return this->position < other.position;
+  }
+
+  bool operator>(const ConstIterator& other) const
+  {
+    return other < *this;
+  }
+
+  bool operator<=(const ConstIterator& other) const
+  {
+    return !(other < *this);
+  }
+
+  bool operator>=(const ConstIterator& other) const
+  {
+    return !(*this < other);
+  }
+};
+
+template <typename Type, std::size_t FirstBlock>
+class SegmentedVector<Type, FirstBlock>::Iterator : public SegmentedVector<Type, FirstBlock>::ConstIterator
+{
+public:
+  using pointer = typename SegmentedVector::pointer;
+  using reference = typename SegmentedVector::reference;
+
+  Iterator()
+  {}
+
+  Iterator(const ConstIterator& other)
+    : ConstIterator(other)
+  {}
+
+  explicit Iterator(SegmentedVector &v, size_t pos) : ConstIterator(v, pos) {}
+
+  Iterator& operator++()
+  {
+    ConstIterator::operator++();
+    return *this;
+  }
+
+  Iterator operator++(int)
+  {
+    auto result = *this;
+    ConstIterator::operator++();
+    return result;
+  }
+
+  Iterator& operator--()
+  {
+    ConstIterator::operator--();
+    return *this;
+  }
+
+  Iterator operator--(int)
+  {
+    auto result = *this;
+    ConstIterator::operator--();
+    return result;
+  }
+
+  Iterator& operator+=(difference_type d)
+  {
+    ConstIterator::operator+=(d);
+    return *this;
+  }
+
+  Iterator& operator-=(difference_type d)
+  {
+    ConstIterator::operator-=(d);
+    return *this;
+  }
+
+  Iterator operator+(difference_type d) const
+  {
+    return ConstIterator::operator+(d);
+  }
+
+  friend Iterator operator+(difference_type d, const Iterator& it)
+  {
+    return it + d;
+  }
+
+  Iterator operator-(difference_type d) const
+  {
+    return ConstIterator::operator-(d);
+  }
+
+  using ConstIterator::operator-;
+
+  reference operator*() const
+  {
+    // ugly cast, yet reduces code duplication.
+    return const_cast<reference>(ConstIterator::operator*());
+  }
+
+  pointer operator->() const
+  {
+    return &this->operator*();
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return const_cast<reference>(ConstIterator::operator[](d));
+  }
+};
+
+}
+
+#endif /* AISDI_LINEAR_SEGMENTEDVECTOR_H */
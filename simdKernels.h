@@ -0,0 +1,608 @@
+#ifndef AISDI_LINEAR_SIMDKERNELS_H
+#define AISDI_LINEAR_SIMDKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "vector.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define AISDI_SIMD_X86 1
+#else
+#define AISDI_SIMD_X86 0
+#endif
+
+#if AISDI_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace aisdi
+{
+
+//search and reduction kernels over arrays of arithmetic types
+//every kernel exists in an SSE2, AVX2 and AVX-512 flavour besides the plain loop,
+//the best one the processor supports is picked at run time; a flavour that would have to
+//emulate lane operations its instruction set lacks (64 bit integer comparisons in SSE2,
+//wide integer multiplications) is the plain loop, bench/simdKernelsBench.cpp compares them
+//
+//results are the ones of the plain loop except for:
+//- sum() and dot() of floating point types, which add in a different order
+//  (one partial sum per lane), so rounding may differ with the instruction set
+//- the sign of a zero returned by min(), max() and minmax()
+//NaNs are treated as by the plain loop: they never compare equal and are skipped
+//by min/max unless the first element is one
+namespace simd
+{
+
+enum class Level { SCALAR, SSE2, AVX2, AVX512 };
+
+inline Level detectLevel()
+{
+#if AISDI_SIMD_X86
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+     && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl")) return Level::AVX512;
+  if(__builtin_cpu_supports("avx2")) return Level::AVX2;
+  if(__builtin_cpu_supports("sse2")) return Level::SSE2;
+#endif
+  return Level::SCALAR;
+}
+
+//the instruction set used by the kernels, detected once
+inline Level level()
+{
+  static const Level detected = detectLevel();
+  return detected;
+}
+
+//integers are summed in 64 bits, floating point types in their own precision
+template <typename T>
+using SumType = typename std::conditional<std::is_floating_point<T>::value, T,
+                typename std::conditional<std::is_signed<T>::value, long long, unsigned long long>::type>::type;
+
+namespace detail
+{
+
+template <typename T>
+struct Vectorizable
+{
+  static const bool value = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value
+                            && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+};
+
+template <typename T, std::size_t Bytes>
+struct Pack
+{
+  typedef T type __attribute__((vector_size(Bytes)));
+  static const std::size_t LANES = Bytes / sizeof(T);
+
+  //unaligned load, vectors are not returned by value to keep the ABI of all flavours alike
+  __attribute__((always_inline)) static void load(type &v, const T *p)
+  {
+    std::memcpy(&v, p, sizeof(v));
+  }
+};
+
+//comparators with a lane-wise counterpart, others make countIf() use the plain loop
+template <typename Compare>
+struct VectorCompare
+{
+  static const bool supported = false;
+};
+
+#define AISDI_SIMD_COMPARE(FUNCTOR, OP)                                           \
+  template <typename U>                                                          \
+  struct VectorCompare<FUNCTOR<U>>                                               \
+  {                                                                              \
+    static const bool supported = true;                                          \
+    template <typename V, typename M>                                            \
+    __attribute__((always_inline)) static void apply(const V &a, const V &b, M &result) \
+    { result = a OP b; }                                                         \
+  };
+
+AISDI_SIMD_COMPARE(std::less, <)
+AISDI_SIMD_COMPARE(std::greater, >)
+AISDI_SIMD_COMPARE(std::less_equal, <=)
+AISDI_SIMD_COMPARE(std::greater_equal, >=)
+AISDI_SIMD_COMPARE(std::equal_to, ==)
+AISDI_SIMD_COMPARE(std::not_equal_to, !=)
+
+#undef AISDI_SIMD_COMPARE
+
+template <typename T>
+std::size_t findScalar(const T *p, std::size_t n, T value)
+{
+  for(std::size_t i = 0; i < n; ++i)
+      if(p[i] == value) return i;
+  return n;
+}
+
+template <typename T, typename Compare>
+std::size_t countIfScalar(const T *p, std::size_t n, T bound, Compare compare)
+{
+  std::size_t total = 0;
+  for(std::size_t i = 0; i < n; ++i)
+      if(compare(p[i], bound)) ++total;
+  return total;
+}
+
+template <typename T>
+std::pair<T, T> minmaxScalar(const T *p, std::size_t n)
+{
+  T least = p[0], greatest = p[0];
+  for(std::size_t i = 1; i < n; ++i){
+      if(p[i] < least) least = p[i];
+      if(greatest < p[i]) greatest = p[i];
+  }
+  return std::make_pair(least, greatest);
+}
+
+template <typename T>
+SumType<T> sumScalar(const T *p, std::size_t n)
+{
+  SumType<T> total = 0;
+  for(std::size_t i = 0; i < n; ++i) total += p[i];
+  return total;
+}
+
+template <typename T>
+SumType<T> dotScalar(const T *a, const T *b, std::size_t n)
+{
+  SumType<T> total = 0;
+  for(std::size_t i = 0; i < n; ++i) total += SumType<T>(a[i]) * SumType<T>(b[i]);
+  return total;
+}
+
+//SSE2 has no 64 bit integer comparisons or multiplications, the bodies fall back to the
+//plain loop rather than emulate them
+template <typename T, std::size_t Bytes>
+struct Emulated
+{
+  static const bool value = Bytes == 16 && std::is_integral<T>::value && sizeof(T) == 8;
+};
+
+//8 and 16 bit integers are summed in 32 bit lanes, a register of elements loaded as such
+//lanes and every element shifted out of its lane (arithmetic shifts sign extend signed
+//ones), as widening conversions of narrow vectors compile to single lane moves; the lanes
+//are flushed every STEPS loop steps, before they can overflow
+template <typename T, bool Products>
+struct Narrow
+{
+  static const bool value = std::is_integral<T>::value && (sizeof(T) == 1 || (sizeof(T) == 2 && !Products));
+  typedef typename std::conditional<std::is_signed<T>::value, std::int32_t, std::uint32_t>::type Lane;
+  static const std::size_t STEPS = Products ? std::size_t(1) << 13 : sizeof(T) == 1 ? std::size_t(1) << 20 : std::size_t(1) << 14;
+  static const int PER_LANE = 4 / sizeof(T);
+
+  //element k of every lane
+  template <typename V, typename U>
+  __attribute__((always_inline)) static void element(V &v, const U &bits, int k)
+  {
+    v = (V)(bits << (32 - 8 * int(sizeof(T)) * (k + 1))) >> (32 - 8 * int(sizeof(T)));
+  }
+};
+
+//integer products dot() leaves to the plain loop: 8 bit elements are multiplied in 32 bit
+//lanes, which SSE2 can't do, 16 bit products overflow those and 16 and 32 bit elements
+//multiplied in 64 bit lanes need AVX-512
+template <typename T, std::size_t Bytes>
+struct ScalarProducts
+{
+  static const bool value = Emulated<T, Bytes>::value
+                            || (std::is_integral<T>::value && (sizeof(T) == 2 || (sizeof(T) == 1 && Bytes == 16) || (sizeof(T) == 4 && Bytes < 64)));
+};
+
+//the bodies below are written once for any vector width and inlined into
+//functions compiled for a given instruction set
+
+template <typename T, std::size_t Bytes>
+__attribute__((always_inline)) inline std::size_t findBody(const T *p, std::size_t n, T value)
+{
+  if constexpr(Emulated<T, Bytes>::value) return findScalar(p, n, value);
+  typedef Pack<T, Bytes> P;
+  const std::size_t L = P::LANES;
+  const typename P::type key = typename P::type{} + value;
+
+  //lanes are checked once per block, the exact position is found by the loop below
+  const std::size_t BLOCK = 16*L;
+  std::size_t i = 0;
+  for(; i + BLOCK <= n; i += BLOCK){
+      typename P::type v;
+      P::load(v, p + i);
+      auto hit = v == key;
+      for(std::size_t j = L; j < BLOCK; j += L){
+          P::load(v, p + i + j);
+          hit |= v == key;
+      }
+      unsigned long long words[Bytes / 8], any = 0;
+      std::memcpy(words, &hit, Bytes);
+      for(std::size_t k = 0; k < Bytes / 8; ++k) any |= words[k];
+      if(any) break;
+  }
+  for(; i < n; ++i)
+      if(p[i] == value) return i;
+  return n;
+}
+
+//counts the elements e with compare(e, bound)
+template <typename T, std::size_t Bytes, typename Compare>
+__attribute__((always_inline)) inline std::size_t countIfBody(const T *p, std::size_t n, T bound, Compare compare)
+{
+  if constexpr(Emulated<T, Bytes>::value) return countIfScalar(p, n, bound, compare);
+  typedef Pack<T, Bytes> P;
+  const std::size_t L = P::LANES;
+  const typename P::type key = typename P::type{} + bound;
+  //true lanes are -1, the counters are as wide as the elements and must not overflow
+  const std::size_t STEPS = sizeof(T) == 1 ? 127 : sizeof(T) == 2 ? 32767 : std::size_t(1) << 20;
+
+  std::size_t total = 0, i = 0;
+  while(i + L <= n){
+      decltype(key == key) counters = {}, hit;
+      for(std::size_t step = 0; step < STEPS && i + L <= n; ++step, i += L){
+          typename P::type v;
+          P::load(v, p + i);
+          VectorCompare<Compare>::apply(v, key, hit);
+          counters += hit;
+      }
+      long long partial = 0;
+      for(std::size_t k = 0; k < L; ++k) partial -= counters[k];
+      total += partial;
+  }
+  for(; i < n; ++i)
+      if(compare(p[i], bound)) ++total;
+  return total;
+}
+
+//n must be positive
+template <typename T, std::size_t Bytes>
+__attribute__((always_inline)) inline std::pair<T, T> minmaxBody(const T *p, std::size_t n)
+{
+  if constexpr(Emulated<T, Bytes>::value) return minmaxScalar(p, n);
+  typedef Pack<T, Bytes> P;
+  const std::size_t L = P::LANES;
+  typename P::type lo = typename P::type{} + p[0], hi = lo;
+
+  std::size_t i = 0;
+  for(; i + L <= n; i += L){
+      typename P::type v;
+      P::load(v, p + i);
+      lo = v < lo ? v : lo;
+      hi = hi < v ? v : hi;
+  }
+  T least = p[0], greatest = p[0];
+  for(std::size_t k = 0; k < L; ++k){
+      if(lo[k] < least) least = lo[k];
+      if(greatest < hi[k]) greatest = hi[k];
+  }
+  for(; i < n; ++i){
+      if(p[i] < least) least = p[i];
+      if(greatest < p[i]) greatest = p[i];
+  }
+  return std::make_pair(least, greatest);
+}
+
+//a step of the wider types loads as many elements as a register of running sums holds,
+//so that widening them takes one instruction; AVX-512 widens a whole register into two
+//well, narrower sets into single lanes
+template <typename T, std::size_t Bytes>
+struct Widened
+{
+  static const std::size_t BYTES = Bytes == 64 ? Bytes * sizeof(SumType<T>) / sizeof(T) : Bytes;
+};
+
+template <typename T, std::size_t Bytes>
+__attribute__((always_inline)) inline SumType<T> sumBody(const T *p, std::size_t n)
+{
+  SumType<T> total = 0;
+  std::size_t i = 0;
+  if constexpr(Narrow<T, false>::value){
+      typedef Narrow<T, false> N;
+      typedef Pack<typename N::Lane, Bytes> W;
+      typedef Pack<std::uint32_t, Bytes> U;
+      const std::size_t L = Bytes / sizeof(T);
+      while(i + L <= n){
+          typename W::type lanes = {};
+          for(std::size_t step = 0; step < N::STEPS && i + L <= n; ++step, i += L){
+              typename U::type bits;
+              std::memcpy(&bits, p + i, Bytes);
+              for(int k = 0; k < N::PER_LANE; ++k){
+                  typename W::type v;
+                  N::element(v, bits, k);
+                  lanes += v;
+              }
+          }
+          for(std::size_t k = 0; k < W::LANES; ++k) total += lanes[k];
+      }
+  }
+  else{
+      typedef Pack<SumType<T>, Widened<T, Bytes>::BYTES> W;
+      const std::size_t L = W::LANES;
+      typedef Pack<T, L * sizeof(T)> P;
+      typename W::type first = {}, second = {};
+      for(; i + 2*L <= n; i += 2*L){
+          typename P::type v, u;
+          P::load(v, p + i);
+          P::load(u, p + i + L);
+          first += __builtin_convertvector(v, typename W::type);
+          second += __builtin_convertvector(u, typename W::type);
+      }
+      first += second;
+      for(std::size_t k = 0; k < L; ++k) total += first[k];
+  }
+  for(; i < n; ++i) total += p[i];
+  return total;
+}
+
+template <typename T, std::size_t Bytes>
+__attribute__((always_inline)) inline SumType<T> dotBody(const T *a, const T *b, std::size_t n)
+{
+  SumType<T> total = 0;
+  std::size_t i = 0;
+  if constexpr(ScalarProducts<T, Bytes>::value) return dotScalar(a, b, n);
+  else if constexpr(Narrow<T, true>::value){
+      typedef Narrow<T, true> N;
+      typedef Pack<typename N::Lane, Bytes> W;
+      typedef Pack<std::uint32_t, Bytes> U;
+      const std::size_t L = Bytes / sizeof(T);
+      while(i + L <= n){
+          typename W::type lanes = {};
+          for(std::size_t step = 0; step < N::STEPS && i + L <= n; ++step, i += L){
+              typename U::type bitsA, bitsB;
+              std::memcpy(&bitsA, a + i, Bytes);
+              std::memcpy(&bitsB, b + i, Bytes);
+              for(int k = 0; k < N::PER_LANE; ++k){
+                  typename W::type va, vb;
+                  N::element(va, bitsA, k);
+                  N::element(vb, bitsB, k);
+                  lanes += va * vb;
+              }
+          }
+          for(std::size_t k = 0; k < W::LANES; ++k) total += lanes[k];
+      }
+  }
+  else{
+      typedef Pack<SumType<T>, Widened<T, Bytes>::BYTES> W;
+      const std::size_t L = W::LANES;
+      typedef Pack<T, L * sizeof(T)> P;
+      typename W::type first = {}, second = {};
+      for(; i + 2*L <= n; i += 2*L){
+          typename P::type va, vb, ua, ub;
+          P::load(va, a + i);
+          P::load(vb, b + i);
+          P::load(ua, a + i + L);
+          P::load(ub, b + i + L);
+          first += __builtin_convertvector(va, typename W::type) * __builtin_convertvector(vb, typename W::type);
+          second += __builtin_convertvector(ua, typename W::type) * __builtin_convertvector(ub, typename W::type);
+      }
+      first += second;
+      for(std::size_t k = 0; k < L; ++k) total += first[k];
+  }
+  for(; i < n; ++i) total += SumType<T>(a[i]) * SumType<T>(b[i]);
+  return total;
+}
+
+#if AISDI_SIMD_X86
+
+#define AISDI_SIMD_KERNELS(SUFFIX, TARGET, BYTES)                                                        \
+  template <typename T>                                                                                 \
+  TARGET std::size_t find##SUFFIX(const T *p, std::size_t n, T value)                                   \
+  { return findBody<T, BYTES>(p, n, value); }                                                           \
+  template <typename T, typename Compare>                                                               \
+  TARGET std::size_t countIf##SUFFIX(const T *p, std::size_t n, T bound, Compare compare)               \
+  { return countIfBody<T, BYTES>(p, n, bound, compare); }                                               \
+  template <typename T>                                                                                 \
+  TARGET std::pair<T, T> minmax##SUFFIX(const T *p, std::size_t n)                                      \
+  { return minmaxBody<T, BYTES>(p, n); }                                                                \
+  template <typename T>                                                                                 \
+  TARGET SumType<T> sum##SUFFIX(const T *p, std::size_t n)                                              \
+  { return sumBody<T, BYTES>(p, n); }                                                                   \
+  template <typename T>                                                                                 \
+  TARGET SumType<T> dot##SUFFIX(const T *a, const T *b, std::size_t n)                                  \
+  { return dotBody<T, BYTES>(a, b, n); }
+
+AISDI_SIMD_KERNELS(Sse2, __attribute__((target("sse2"))), 16)
+AISDI_SIMD_KERNELS(Avx2, __attribute__((target("avx2"))), 32)
+AISDI_SIMD_KERNELS(Avx512, __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl"))), 64)
+
+#undef AISDI_SIMD_KERNELS
+
+//calls the kernel of the detected instruction set, or the plain loop
+#define AISDI_SIMD_DISPATCH(T, KERNEL, ...)                                                              \
+  if constexpr(detail::Vectorizable<T>::value){                                                         \
+      switch(level()){                                                                                  \
+      case Level::AVX512: return detail::KERNEL##Avx512(__VA_ARGS__);                                   \
+      case Level::AVX2: return detail::KERNEL##Avx2(__VA_ARGS__);                                       \
+      case Level::SSE2: return detail::KERNEL##Sse2(__VA_ARGS__);                                       \
+      default: break;                                                                                   \
+      }                                                                                                 \
+  }                                                                                                     \
+  return detail::KERNEL##Scalar(__VA_ARGS__);
+
+#else
+
+#define AISDI_SIMD_DISPATCH(T, KERNEL, ...) return detail::KERNEL##Scalar(__VA_ARGS__);
+
+#endif
+
+}
+
+//index of the first element equal to value, n if there is none
+template <typename T>
+std::size_t find(const T *p, std::size_t n, T value)
+{
+  static_assert(std::is_arithmetic<T>::value, "SIMD kernels work on arithmetic types");
+  AISDI_SIMD_DISPATCH(T, find, p, n, value)
+}
+
+//number of elements e with compare(e, bound); std::less, std::greater, std::less_equal,
+//std::greater_equal, std::equal_to and std::not_equal_to are vectorized
+template <typename T, typename Compare>
+std::size_t countIf(const T *p, std::size_t n, T bound, Compare compare)
+{
+  static_assert(std::is_arithmetic<T>::value, "SIMD kernels work on arithmetic types");
+  if constexpr(!detail::VectorCompare<Compare>::supported) return detail::countIfScalar(p, n, bound, compare);
+  else{
+      AISDI_SIMD_DISPATCH(T, countIf, p, n, bound, compare)
+  }
+}
+
+//the least and the greatest element, n must be positive
+template <typename T>
+std::pair<T, T> minmax(const T *p, std::size_t n)
+{
+  static_assert(std::is_arithmetic<T>::value, "SIMD kernels work on arithmetic types");
+  AISDI_SIMD_DISPATCH(T, minmax, p, n)
+}
+
+template <typename T>
+SumType<T> sum(const T *p, std::size_t n)
+{
+  static_assert(std::is_arithmetic<T>::value, "SIMD kernels work on arithmetic types");
+  AISDI_SIMD_DISPATCH(T, sum, p, n)
+}
+
+template <typename T>
+SumType<T> dot(const T *a, const T *b, std::size_t n)
+{
+  static_assert(std::is_arithmetic<T>::value, "SIMD kernels work on arithmetic types");
+  AISDI_SIMD_DISPATCH(T, dot, a, b, n)
+}
+
+#undef AISDI_SIMD_DISPATCH
+
+namespace detail
+{
+
+inline std::size_t popcountScalar(const std::uint64_t *p, std::size_t n)
+{
+  std::size_t total = 0;
+  for(std::size_t i = 0; i < n; ++i) total += __builtin_popcountll(p[i]);
+  return total;
+}
+
+#if AISDI_SIMD_X86
+
+__attribute__((target("popcnt"))) inline std::size_t popcountPopcnt(const std::uint64_t *p, std::size_t n)
+{
+  std::size_t total = 0;
+  for(std::size_t i = 0; i < n; ++i) total += __builtin_popcountll(p[i]);
+  return total;
+}
+
+//bits of every nibble looked up with pshufb, the byte counts summed with psadbw
+__attribute__((target("avx2,popcnt"))) inline std::size_t popcountAvx2(const std::uint64_t *p, std::size_t n)
+{
+  const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i nibble = _mm256_set1_epi8(0x0f);
+  __m256i total = _mm256_setzero_si256();
+  std::size_t i = 0;
+  for(; i + 4 <= n; i += 4){
+      __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+      __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(v, nibble));
+      __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+      total = _mm256_add_epi64(total, _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256()));
+  }
+  std::uint64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), total);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3] + popcountPopcnt(p + i, n - i);
+}
+
+#endif
+
+}
+
+//number of set bits in n words
+inline std::size_t popcount(const std::uint64_t *p, std::size_t n)
+{
+#if AISDI_SIMD_X86
+  static const bool hardware = (__builtin_cpu_init(), __builtin_cpu_supports("popcnt"));
+  if(hardware && n >= 16 && level() >= Level::AVX2) return detail::popcountAvx2(p, n);
+  if(hardware) return detail::popcountPopcnt(p, n);
+#endif
+  return detail::popcountScalar(p, n);
+}
+
+}
+
+template <typename T, typename G>
+typename Vector<T, G>::const_iterator find(const Vector<T, G>& v, const T& value)
+{
+  return typename Vector<T, G>::const_iterator(v, simd::find(v.data(), v.getSize(), value));
+}
+
+template <typename T, typename G>
+std::size_t count(const Vector<T, G>& v, const T& value)
+{
+  return simd::countIf(v.data(), v.getSize(), value, std::equal_to<T>());
+}
+
+template <typename T, typename G>
+bool contains(const Vector<T, G>& v, const T& value)
+{
+  return simd::find(v.data(), v.getSize(), value) != v.getSize();
+}
+
+//number of elements e with compare(e, bound), e.g. countIf(v, 10, std::less<int>())
+template <typename T, typename G, typename Compare>
+std::size_t countIf(const Vector<T, G>& v, const T& bound, Compare compare)
+{
+  return simd::countIf(v.data(), v.getSize(), bound, compare);
+}
+
+template <typename T, typename G>
+std::pair<T, T> minmax(const Vector<T, G>& v)
+{
+  if(v.isEmpty()) throw std::logic_error("Looking for the extremes of an empty vector");
+  return simd::minmax(v.data(), v.getSize());
+}
+
+template <typename T, typename G>
+T min(const Vector<T, G>& v)
+{
+  return minmax(v).first;
+}
+
+template <typename T, typename G>
+T max(const Vector<T, G>& v)
+{
+  return minmax(v).second;
+}
+
+//index of the first least element
+template <typename T, typename G>
+std::size_t argmin(const Vector<T, G>& v)
+{
+  std::size_t index = simd::find(v.data(), v.getSize(), minmax(v).first);
+  //a NaN first element is the minimum and isn't equal to itself
+  return index == v.getSize() ? 0 : index;
+}
+
+//index of the first greatest element
+template <typename T, typename G>
+std::size_t argmax(const Vector<T, G>& v)
+{
+  std::size_t index = simd::find(v.data(), v.getSize(), minmax(v).second);
+  return index == v.getSize() ? 0 : index;
+}
+
+template <typename T, typename G>
+simd::SumType<T> sum(const Vector<T, G>& v)
+{
+  return simd::sum(v.data(), v.getSize());
+}
+
+template <typename T, typename G>
+simd::SumType<T> dot(const Vector<T, G>& a, const Vector<T, G>& b)
+{
+  if(a.getSize() != b.getSize()) throw std::logic_error("Dot product of vectors of different sizes");
+  return simd::dot(a.data(), b.data(), a.getSize());
+}
+
+}
+
+#endif /* AISDI_LINEAR_SIMDKERNELS_H */
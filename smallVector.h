@@ -0,0 +1,633 @@
+#ifndef AISDI_LINEAR_SMALLVECTOR_H
+#define AISDI_LINEAR_SMALLVECTOR_H
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace aisdi
+{
+
+//vector keeping up to N elements inside the object itself, the heap is used only
+//once it grows past N; the API follows Vector
+template <typename Type, std::size_t N>
+class SmallVector
+{
+  static_assert(N > 0, "SmallVector needs room for at least one inline element");
+
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = Type;
+  using pointer = Type*;
+  using reference = Type&;
+  using const_pointer = const Type*;
+  using const_reference = const Type&;
+
+  class ConstIterator;
+  class Iterator;
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+
+  SmallVector() : _data(inlineData()), _size(0), _capacity(N) {}
+
+  SmallVector(std::initializer_list<Type> l) : SmallVector()
+  {
+    reserve(l.size());
+    for(auto &i : l) append(i);
+  }
+
+  SmallVector(const SmallVector& other) : SmallVector()
+  {
+    reserve(other._size);
+    for(size_type i = 0; i < other._size; ++i) append(other._data[i]);
+  }
+
+  //moving inline elements is the only part that may throw
+  SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<Type>::value) : SmallVector()
+  {
+    takeFrom(other);
+  }
+
+  ~SmallVector()
+  {
+    destroyElements();
+    releaseHeap();
+  }
+
+  SmallVector& operator=(const SmallVector& other)
+  {
+    if(&other == this) return *this;
+
+    destroyElements();
+    reserve(other._size);
+    for(size_type i = 0; i < other._size; ++i) append(other._data[i]);
+    return *this;
+  }
+
+  SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<Type>::value)
+  {
+    if(&other == this) return *this;
+
+    destroyElements();
+    releaseHeap();
+    takeFrom(other);
+    return *this;
+  }
+
+  const Type& operator[](size_type index) const
+  {
+    return _data[index];
+  }
+
+  Type& operator[](size_type index)
+  {
+    return _data[index];
+  }
+
+  const Type* data() const
+  {
+    return _data;
+  }
+
+  Type* data()
+  {
+    return _data;
+  }
+
+  bool isEmpty() const
+  {
+    return !_size;
+  }
+
+  size_type getSize() const
+  {
+    return _size;
+  }
+
+  size_type capacity() const
+  {
+    return _capacity;
+  }
+
+  //tells whether the elements still live in the object's own buffer
+  bool isInline() const
+  {
+    return _data == inlineData();
+  }
+
+  void reserve(size_type count)
+  {
+    if(count > _capacity) reallocate(count);
+  }
+
+  void append(const Type& item)
+  {
+    emplaceBack(item);
+  }
+
+  void append(Type&& item)
+  {
+    emplaceBack(std::move(item));
+  }
+
+  template <typename... Args>
+  Type& emplaceBack(Args&&... args)
+  {
+    if(_size == _capacity) growAndEmplace(_size, std::forward<Args>(args)...);
+    else new (_data + _size) Type(std::forward<Args>(args)...);
+    return _data[_size++];
+  }
+
+  void prepend(const Type& item)
+  {
+    emplace(cbegin(), item);
+  }
+
+  void prepend(Type&& item)
+  {
+    emplace(cbegin(), std::move(item));
+  }
+
+  void insert(const const_iterator& insertPosition, const Type& item)
+  {
+    emplace(insertPosition, item);
+  }
+
+  void insert(const const_iterator& insertPosition, Type&& item)
+  {
+    emplace(insertPosition, std::move(item));
+  }
+
+  template <typename... Args>
+  iterator emplace(const const_iterator& insertPosition, Args&&... args)
+  {
+    size_type pos = insertPosition.position;
+    if(pos > _size) throw std::out_of_range("Inserting beyond the end()");
+
+    if(pos == _size){
+        emplaceBack(std::forward<Args>(args)...);
+        return iterator(*this, pos);
+    }
+    if(_size == _capacity){
+        growAndEmplace(pos, std::forward<Args>(args)...);
+        ++_size;
+        return iterator(*this, pos);
+    }
+
+    //args may refer to an element of this vector, so the value is built before anything moves
+    Type item(std::forward<Args>(args)...);
+    new (_data + _size) Type(std::move(_data[_size-1]));
+    ++_size;
+    for(size_type i = _size-2; i > pos; --i) _data[i] = std::move(_data[i-1]);
+    _data[pos] = std::move(item);
+    return iterator(*this, pos);
+  }
+
+  Type popFirst()
+  {
+    if(isEmpty()) throw std::logic_error("Popping element when the vector is empty");
+
+    Type value = std::move(_data[0]);
+    for(size_type i = 1; i < _size; ++i) _data[i-1] = std::move(_data[i]);
+    _data[--_size].~Type();
+    return value;
+  }
+
+  Type popLast()
+  {
+    if(isEmpty()) throw std::logic_error("Popping element when the vector is empty");
+
+    Type value = std::move(_data[_size-1]);
+    _data[--_size].~Type();
+    return value;
+  }
+
+  void erase(const const_iterator& position)
+  {
+    if(isEmpty()) throw std::out_of_range("Erasing when array is empty");
+    if(position.position >= _size) throw std::out_of_range("Erasing end() element");
+
+    for(size_type i = position.position + 1; i < _size; ++i) _data[i-1] = std::move(_data[i]);
+    _data[--_size].~Type();
+  }
+
+  void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+  {
+    size_type first = firstIncluded.position, last = lastExcluded.position;
+    if(first > last || last > _size) throw std::out_of_range("Erasing beyond the vector");
+    if(first == last) return;
+
+    for(size_type i = first, j = last; j < _size; ++i, ++j) _data[i] = std::move(_data[j]);
+    for(size_type i = _size - (last - first); i < _size; ++i) _data[i].~Type();
+    _size -= last - first;
+  }
+
+  //drops the elements, the heap buffer (if any) is kept
+  void clear()
+  {
+    destroyElements();
+  }
+
+  bool operator==(const SmallVector& other) const
+  {
+    if(_size != other._size) return false;
+    for(size_type i = 0; i < _size; ++i)
+        if(_data[i] != other._data[i]) return false;
+    return true;
+  }
+
+  bool operator!=(const SmallVector& other) const
+  {
+    return !(*this == other);
+  }
+
+  iterator begin()
+  {
+    return iterator(*this, 0);
+  }
+
+  iterator end()
+  {
+    return iterator(*this, _size);
+  }
+
+  const_iterator cbegin() const
+  {
+    return const_iterator(*this, 0);
+  }
+
+  const_iterator cend() const
+  {
+    return const_iterator(*this, _size);
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+
+private:
+  static const bool BITWISE = std::is_trivially_copyable<Type>::value;
+
+  alignas(Type) unsigned char _inline[N * sizeof(Type)];
+  pointer _data;
+  size_type _size, _capacity;
+
+  pointer inlineData()
+  {
+    return reinterpret_cast<pointer>(_inline);
+  }
+
+  const_pointer inlineData() const
+  {
+    return reinterpret_cast<const_pointer>(_inline);
+  }
+
+  static pointer allocate(size_type count)
+  {
+    if(alignof(Type) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        return static_cast<pointer>(::operator new(count * sizeof(Type), std::align_val_t(alignof(Type))));
+    return static_cast<pointer>(::operator new(count * sizeof(Type)));
+  }
+
+  static void deallocate(pointer p)
+  {
+    if(alignof(Type) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) ::operator delete(p, std::align_val_t(alignof(Type)));
+    else ::operator delete(p);
+  }
+
+  void releaseHeap()
+  {
+    if(!isInline()) deallocate(_data);
+    _data = inlineData();
+    _capacity = N;
+  }
+
+  void destroyElements()
+  {
+    for(size_type i = 0; i < _size; ++i) _data[i].~Type();
+    _size = 0;
+  }
+
+  //expects this vector to be empty and inline; a heap buffer is taken over as is,
+  //inline elements are moved one by one (there are at most N of them)
+  void takeFrom(SmallVector &other)
+  {
+    if(!other.isInline()){
+        _data = other._data;
+        _size = other._size;
+        _capacity = other._capacity;
+        other._data = other.inlineData();
+        other._size = 0;
+        other._capacity = N;
+        return;
+    }
+
+    if(BITWISE) std::memcpy(static_cast<void*>(_data), other._data, other._size * sizeof(Type));
+    else for(size_type i = 0; i < other._size; ++i) new (_data + i) Type(std::move(other._data[i]));
+    _size = other._size;
+    other.destroyElements();
+  }
+
+  //moves [from, to) into raw memory at 'target', copying when moving could throw
+  static void relocate(pointer from, pointer to, pointer target)
+  {
+    if(BITWISE){
+        if(from != to) std::memcpy(static_cast<void*>(target), from, (to - from) * sizeof(Type));
+        return;
+    }
+    pointer built = target;
+    try{
+        for(; from != to; ++from, ++built) new (built) Type(std::move_if_noexcept(*from));
+    }
+    catch(...){
+        for(; target != built; ++target) target->~Type();
+        throw;
+    }
+  }
+
+  void adopt(pointer newData, size_type newCapacity)
+  {
+    size_type count = _size;
+    if(!BITWISE) destroyElements();
+    releaseHeap();
+    _data = newData;
+    _size = count;
+    _capacity = newCapacity;
+  }
+
+  void reallocate(size_type newCapacity)
+  {
+    pointer newData = allocate(newCapacity);
+    try{
+        relocate(_data, _data + _size, newData);
+    }
+    catch(...){
+        deallocate(newData);
+        throw;
+    }
+    adopt(newData, newCapacity);
+  }
+
+  //grows to the heap with a new element built at 'pos' first, as args may refer to
+  //an element being moved; size is left to the caller
+  template <typename... Args>
+  void growAndEmplace(size_type pos, Args&&... args)
+  {
+    size_type newCapacity = _capacity * 2;
+    pointer newData = allocate(newCapacity);
+    try{
+        new (newData + pos) Type(std::forward<Args>(args)...);
+        try{
+            relocate(_data, _data + pos, newData);
+            try{
+                relocate(_data + pos, _data + _size, newData + pos + 1);
+            }
+            catch(...){
+                for(size_type i = 0; i < pos; ++i) newData[i].~Type();
+                throw;
+            }
+        }
+        catch(...){
+            newData[pos].~Type();
+            throw;
+        }
+    }
+    catch(...){
+        deallocate(newData);
+        throw;
+    }
+    adopt(newData, newCapacity);
+  }
+};
+
+template <typename Type, std::size_t N>
+class SmallVector<Type, N>::ConstIterator
+{
+protected:
+  const SmallVector *vec;
+
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename SmallVector::value_type;
+  using difference_type = typename SmallVector::difference_type;
+  using pointer = typename SmallVector::const_pointer;
+  using reference = typename SmallVector::const_reference;
+
+  size_t position;
+
+  ConstIterator() : vec(nullptr), position(0) {}
+
+  explicit ConstIterator(const SmallVector &v, size_t pos) : vec(&v), position(pos) {}
+
+  reference operator*() const
+  {
+    if(this->position == vec->getSize()) throw std::out_of_range("Tried to get value of end() element");
+    return (*vec)[position];
+  }
+
+  pointer operator->() const
+  {
+    return &this->operator*();
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return (*vec)[position + d];
+  }
+
+  ConstIterator& operator++()
+  {
+    if(++(this->position) > vec->getSize()) throw std::out_of_range("Array exceeded");
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator tmp = *this;
+    ++(*this);
+    return tmp;
+  }
+
+  ConstIterator& operator--()
+  {
+    if(this->position == 0) throw std::out_of_range("Array exceeded");
+    this->position--;
+    return *this;
+  }
+
+  ConstIterator operator--(int)
+  {
+    ConstIterator tmp = *this;
+    --(*this);
+    return tmp;
+  }
+
+  ConstIterator& operator+=(difference_type d)
+  {
+    difference_type target = static_cast<difference_type>(this->position) + d;
+    if(target < 0 || target > static_cast<difference_type>(vec->getSize())) throw std::out_of_range("Array exceeded");
+    this->position = target;
+    return *this;
+  }
+
+  ConstIterator& operator-=(difference_type d)
+  {
+    return *this += -d;
+  }
+
+  ConstIterator operator+(difference_type d) const
+  {
+    ConstIterator tmp = *this;
+    return tmp += d;
+  }
+
+  friend ConstIterator operator+(difference_type d, const ConstIterator& it)
+  {
+    return it + d;
+  }
+
+  ConstIterator operator-(difference_type d) const
+  {
+    ConstIterator tmp = *this;
+    return tmp -= d;
+  }
+
+  difference_type operator-(const ConstIterator& other) const
+  {
+    return static_cast<difference_type>(this->position) - static_cast<difference_type>(other.position);
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return this->position == other.position;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+
+  bool operator<(const ConstIterator& other) const
+  {
+    return this->position < other.position;
+  }
+
+  bool operator>(const ConstIterator& other) const
+  {
+    return other < *this;
+  }
+
+  bool operator<=(const ConstIterator& other) const
+  {
+    return !(other < *this);
+  }
+
+  bool operator>=(const ConstIterator& other) const
+  {
+    return !(*this < other);
+  }
+};
+
+template <typename Type, std::size_t N>
+class SmallVector<Type, N>::Iterator : public SmallVector<Type, N>::ConstIterator
+{
+public:
+  using pointer = typename SmallVector::pointer;
+  using reference = typename SmallVector::reference;
+
+  Iterator()
+  {}
+
+  Iterator(const ConstIterator& other)
+    : ConstIterator(other)
+  {}
+
+  explicit Iterator(SmallVector &v, size_t pos) : ConstIterator(v, pos) {}
+
+  Iterator& operator++()
+  {
+    ConstIterator::operator++();
+    return *this;
+  }
+
+  Iterator operator++(int)
+  {
+    auto result = *this;
+    ConstIterator::operator++();
+    return result;
+  }
+
+  Iterator& operator--()
+  {
+    ConstIterator::operator--();
+    return *this;
+  }
+
+  Iterator operator--(int)
+  {
+    auto result = *this;
+    ConstIterator::operator--();
+    return result;
+  }
+
+  Iterator& operator+=(difference_type d)
+  {
+    ConstIterator::operator+=(d);
+    return *this;
+  }
+
+  Iterator& operator-=(difference_type d)
+  {
+    ConstIterator::operator-=(d);
+    return *this;
+  }
+
+  Iterator operator+(difference_type d) const
+  {
+    return ConstIterator::operator+(d);
+  }
+
+  friend Iterator operator+(difference_type d, const Iterator& it)
+  {
+    return it + d;
+  }
+
+  Iterator operator-(difference_type d) const
+  {
+    return ConstIterator::operator-(d);
+  }
+
+  using ConstIterator::operator-;
+
+  reference operator*() const
+  {
+    // ugly cast, yet reduces code duplication.
+    return const_cast<reference>(ConstIterator::operator*());
+  }
+
+  pointer operator->() const
+  {
+    return &this->operator*();
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return const_cast<reference>(ConstIterator::operator[](d));
+  }
+};
+
+}
+
+#endif /* AISDI_LINEAR_SMALLVECTOR_H */
@@ -0,0 +1,755 @@
+#ifndef AISDI_LINEAR_SOAVECTOR_H
+#define AISDI_LINEAR_SOAVECTOR_H
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace aisdi
+{
+
+//vector of records stored as a structure of arrays: every field lives in its own
+//contiguous column, so a loop reading two fields out of eight loads only those two;
+//operator[] and the iterators give proxies reaching the fields of one record and
+//column<I>() gives a whole field as a plain array, e.g. for the simd kernels
+template <typename... Fields>
+class SoAVector
+{
+  static_assert(sizeof...(Fields) > 0, "SoAVector needs at least one field");
+
+public:
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using value_type = std::tuple<Fields...>;
+
+  template <size_type I>
+  using FieldType = typename std::tuple_element<I, value_type>::type;
+
+  static constexpr size_type FIELDS = sizeof...(Fields);
+  //columns start on a cache line, so vector loads over a column don't straddle two lines at its start
+  static constexpr size_type ALIGNMENT = 64;
+
+  class Reference;
+  class ConstReference;
+  template <typename T>
+  class Column;
+  class ConstIterator;
+  class Iterator;
+  using reference = Reference;
+  using const_reference = ConstReference;
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+
+  SoAVector() : _columns(), _size(0), _capacity(0) {}
+
+  SoAVector(std::initializer_list<value_type> l) : SoAVector()
+  {
+    reserve(l.size());
+    for(auto &i : l) append(i);
+  }
+
+  SoAVector(const SoAVector& other) : SoAVector()
+  {
+    reserve(other._size);
+    for(size_type i = 0; i < other._size; ++i) append(other[i]);
+  }
+
+  SoAVector(SoAVector&& other) noexcept : _columns(other._columns), _size(other._size), _capacity(other._capacity)
+  {
+    other._columns = std::tuple<Fields*...>();
+    other._size = other._capacity = 0;
+  }
+
+  ~SoAVector()
+  {
+    clear();
+    release(_columns);
+  }
+
+  SoAVector& operator=(const SoAVector& other)
+  {
+    if(&other == this) return *this;
+
+    clear();
+    reserve(other._size);
+    for(size_type i = 0; i < other._size; ++i) append(other[i]);
+    return *this;
+  }
+
+  SoAVector& operator=(SoAVector&& other) noexcept
+  {
+    if(&other == this) return *this;
+
+    clear();
+    release(_columns);
+    _columns = other._columns;
+    _size = other._size, _capacity = other._capacity;
+    other._columns = std::tuple<Fields*...>();
+    other._size = other._capacity = 0;
+    return *this;
+  }
+
+  Reference operator[](size_type index)
+  {
+    return Reference(*this, index);
+  }
+
+  ConstReference operator[](size_type index) const
+  {
+    return ConstReference(*this, index);
+  }
+
+  //start of the column of field I, aligned to ALIGNMENT
+  template <size_type I>
+  FieldType<I>* data()
+  {
+    return std::get<I>(_columns);
+  }
+
+  template <size_type I>
+  const FieldType<I>* data() const
+  {
+    return std::get<I>(_columns);
+  }
+
+  //field I of every record as an array, valid until the vector reallocates
+  template <size_type I>
+  Column<FieldType<I>> column()
+  {
+    return Column<FieldType<I>>(std::get<I>(_columns), _size);
+  }
+
+  template <size_type I>
+  Column<const FieldType<I>> column() const
+  {
+    return Column<const FieldType<I>>(std::get<I>(_columns), _size);
+  }
+
+  bool isEmpty() const
+  {
+    return !_size;
+  }
+
+  size_type getSize() const
+  {
+    return _size;
+  }
+
+  size_type capacity() const
+  {
+    return _capacity;
+  }
+
+  void reserve(size_type count)
+  {
+    if(count > _capacity) reallocate(count);
+  }
+
+  void shrinkToFit()
+  {
+    if(_size < _capacity) reallocate(_size);
+  }
+
+  void append(const value_type& record)
+  {
+    emplaceRow(record);
+  }
+
+  void append(value_type&& record)
+  {
+    emplaceRow(std::move(record));
+  }
+
+  //takes one constructor argument per field
+  template <typename... Args>
+  Reference emplaceBack(Args&&... fields)
+  {
+    static_assert(sizeof...(Args) == FIELDS, "emplaceBack takes one value per field");
+    return emplaceRow(std::forward_as_tuple(std::forward<Args>(fields)...));
+  }
+
+  value_type popLast()
+  {
+    if(isEmpty()) throw std::logic_error("Popping element when the vector is empty");
+
+    value_type value = takeRow(_size - 1, std::index_sequence_for<Fields...>());
+    destroyRows(_size - 1, _size);
+    --_size;
+    return value;
+  }
+
+  void erase(const const_iterator& position)
+  {
+    if(isEmpty()) throw std::out_of_range("Erasing when array is empty");
+    if(position.position >= _size) throw std::out_of_range("Erasing end() element");
+
+    eraseRows(position.position, position.position + 1);
+  }
+
+  void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
+  {
+    size_type first = firstIncluded.position, last = lastExcluded.position;
+    if(first > last || last > _size) throw std::out_of_range("Erasing beyond the vector");
+    if(first == last) return;
+
+    eraseRows(first, last);
+  }
+
+  //drops the records, the columns are kept
+  void clear()
+  {
+    destroyRows(0, _size);
+    _size = 0;
+  }
+
+  bool operator==(const SoAVector& other) const
+  {
+    if(_size != other._size) return false;
+    bool equal = true;
+    forEachField([&](auto field){
+        constexpr size_type I = decltype(field)::value;
+        for(size_type i = 0; equal && i < _size; ++i)
+            if(!(std::get<I>(_columns)[i] == std::get<I>(other._columns)[i])) equal = false;
+    });
+    return equal;
+  }
+
+  bool operator!=(const SoAVector& other) const
+  {
+    return !(*this == other);
+  }
+
+  iterator begin()
+  {
+    return iterator(*this, 0);
+  }
+
+  iterator end()
+  {
+    return iterator(*this, _size);
+  }
+
+  const_iterator cbegin() const
+  {
+    return const_iterator(*this, 0);
+  }
+
+  const_iterator cend() const
+  {
+    return const_iterator(*this, _size);
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+
+private:
+  std::tuple<Fields*...> _columns;
+  size_type _size, _capacity;
+
+  //f(std::integral_constant<size_type, I>()) for every field in order
+  template <typename F>
+  static void forEachField(F&& f)
+  {
+    forEachField(f, std::index_sequence_for<Fields...>());
+  }
+
+  template <typename F, size_type... I>
+  static void forEachField(F& f, std::index_sequence<I...>)
+  {
+    (f(std::integral_constant<size_type, I>()), ...);
+  }
+
+  template <typename T>
+  static constexpr std::align_val_t columnAlignment()
+  {
+    return std::align_val_t(alignof(T) > ALIGNMENT ? alignof(T) : ALIGNMENT);
+  }
+
+  static void release(std::tuple<Fields*...>& columns)
+  {
+    forEachField([&](auto field){
+        constexpr size_type I = decltype(field)::value;
+        if(std::get<I>(columns) != nullptr) ::operator delete(std::get<I>(columns), columnAlignment<FieldType<I>>());
+        std::get<I>(columns) = nullptr;
+    });
+  }
+
+  void destroyRows(size_type first, size_type last)
+  {
+    forEachField([&](auto field){
+        constexpr size_type I = decltype(field)::value;
+        using T = FieldType<I>;
+        if(!std::is_trivially_destructible<T>::value)
+            for(size_type i = first; i < last; ++i) std::get<I>(_columns)[i].~T();
+    });
+  }
+
+  //moves the column of field I into 'target', copying when moving could throw;
+  //cleans up what it built if it throws
+  template <size_type I>
+  void relocateColumn(FieldType<I> *target)
+  {
+    using T = FieldType<I>;
+    T *from = std::get<I>(_columns);
+    if(std::is_trivially_copyable<T>::value){
+        if(_size) std::memcpy(static_cast<void*>(target), from, _size * sizeof(T));
+        return;
+    }
+    size_type built = 0;
+    try{
+        for(; built < _size; ++built) new (target + built) T(std::move_if_noexcept(from[built]));
+    }
+    catch(...){
+        for(size_type i = 0; i < built; ++i) target[i].~T();
+        throw;
+    }
+  }
+
+  //columns whose elements may only be copied go first: if one of them throws,
+  //no column has been moved out yet and the vector is left as it was
+  void reallocate(size_type newCapacity)
+  {
+    std::tuple<Fields*...> fresh;
+    bool relocated[FIELDS] = {};
+    try{
+        forEachField([&](auto field){
+            constexpr size_type I = decltype(field)::value;
+            using T = FieldType<I>;
+            std::get<I>(fresh) = newCapacity ? static_cast<T*>(::operator new(newCapacity * sizeof(T), columnAlignment<T>())) : nullptr;
+        });
+        forEachField([&](auto field){
+            constexpr size_type I = decltype(field)::value;
+            if(!std::is_nothrow_move_constructible<FieldType<I>>::value){
+                relocateColumn<I>(std::get<I>(fresh));
+                relocated[I] = true;
+            }
+        });
+    }
+    catch(...){
+        forEachField([&](auto field){
+            constexpr size_type I = decltype(field)::value;
+            using T = FieldType<I>;
+            if(relocated[I]) for(size_type i = 0; i < _size; ++i) std::get<I>(fresh)[i].~T();
+        });
+        release(fresh);
+        throw;
+    }
+    forEachField([&](auto field){
+        constexpr size_type I = decltype(field)::value;
+        if(std::is_nothrow_move_constructible<FieldType<I>>::value) relocateColumn<I>(std::get<I>(fresh));
+    });
+
+    destroyRows(0, _size);
+    release(_columns);
+    _columns = fresh;
+    _capacity = newCapacity;
+  }
+
+  size_type grownSize() const
+  {
+    return _capacity ? _capacity * 2 : 10;
+  }
+
+  //builds field I of row 'row' from element I of 'values', fields built so far are
+  //destroyed if one throws
+  template <typename Tuple, size_type... I>
+  void constructRow(size_type row, Tuple&& values, std::index_sequence<I...>)
+  {
+    size_type built = 0;
+    try{
+        ((new (std::get<I>(_columns) + row) FieldType<I>(std::get<I>(std::forward<Tuple>(values))), ++built), ...);
+    }
+    catch(...){
+        forEachField([&](auto field){
+            constexpr size_type J = decltype(field)::value;
+            using T = FieldType<J>;
+            if(J < built) std::get<J>(_columns)[row].~T();
+        });
+        throw;
+    }
+  }
+
+  template <typename Tuple>
+  Reference emplaceRow(Tuple&& values)
+  {
+    if(_size == _capacity){
+        //the values may refer to a record of this vector, which growing would move
+        value_type record(std::forward<Tuple>(values));
+        reallocate(grownSize());
+        constructRow(_size, std::move(record), std::index_sequence_for<Fields...>());
+    }
+    else constructRow(_size, std::forward<Tuple>(values), std::index_sequence_for<Fields...>());
+    return Reference(*this, _size++);
+  }
+
+  template <size_type... I>
+  value_type takeRow(size_type row, std::index_sequence<I...>)
+  {
+    return value_type(std::move(std::get<I>(_columns)[row])...);
+  }
+
+  template <size_type... I>
+  value_type copyRow(size_type row, std::index_sequence<I...>) const
+  {
+    return value_type(std::get<I>(_columns)[row]...);
+  }
+
+  template <typename Tuple, size_type... I>
+  void assignRow(size_type row, Tuple&& values, std::index_sequence<I...>)
+  {
+    ((std::get<I>(_columns)[row] = std::get<I>(std::forward<Tuple>(values))), ...);
+  }
+
+  //shifts every column once, with memmove where the field is trivially copyable
+  void eraseRows(size_type first, size_type last)
+  {
+    size_type count = last - first;
+    forEachField([&](auto field){
+        constexpr size_type I = decltype(field)::value;
+        using T = FieldType<I>;
+        T *column = std::get<I>(_columns);
+        if(std::is_trivially_copyable<T>::value){
+            std::memmove(static_cast<void*>(column + first), column + last, (_size - last) * sizeof(T));
+            return;
+        }
+        for(size_type i = first, j = last; j < _size; ++i, ++j) column[i] = std::move(column[j]);
+    });
+    destroyRows(_size - count, _size);
+    _size -= count;
+  }
+};
+
+//the fields of one record, assigning a record to it writes them in place
+template <typename... Fields>
+class SoAVector<Fields...>::Reference
+{
+public:
+  explicit Reference(SoAVector &v, size_type index) : vec(&v), index(index) {}
+
+  template <size_type I>
+  FieldType<I>& get() const
+  {
+    return std::get<I>(vec->_columns)[index];
+  }
+
+  //copies the fields, as assigning a reference to a record does
+  Reference& operator=(const Reference& other)
+  {
+    vec->assignRow(index, static_cast<value_type>(other), std::index_sequence_for<Fields...>());
+    return *this;
+  }
+
+  Reference& operator=(const value_type& record)
+  {
+    vec->assignRow(index, record, std::index_sequence_for<Fields...>());
+    return *this;
+  }
+
+  Reference& operator=(value_type&& record)
+  {
+    vec->assignRow(index, std::move(record), std::index_sequence_for<Fields...>());
+    return *this;
+  }
+
+  operator value_type() const
+  {
+    return vec->copyRow(index, std::index_sequence_for<Fields...>());
+  }
+
+private:
+  friend class ConstReference;
+
+  SoAVector *vec;
+  size_type index;
+};
+
+template <typename... Fields>
+class SoAVector<Fields...>::ConstReference
+{
+public:
+  explicit ConstReference(const SoAVector &v, size_type index) : vec(&v), index(index) {}
+
+  ConstReference(const Reference& other) : vec(other.vec), index(other.index) {}
+
+  template <size_type I>
+  const FieldType<I>& get() const
+  {
+    return std::get<I>(vec->_columns)[index];
+  }
+
+  operator value_type() const
+  {
+    return vec->copyRow(index, std::index_sequence_for<Fields...>());
+  }
+
+private:
+  const SoAVector *vec;
+  size_type index;
+};
+
+//one field of every record as a plain array
+template <typename... Fields>
+template <typename T>
+class SoAVector<Fields...>::Column
+{
+public:
+  Column(T *data, size_type size) : _data(data), _size(size) {}
+
+  T* data() const
+  {
+    return _data;
+  }
+
+  size_type getSize() const
+  {
+    return _size;
+  }
+
+  bool isEmpty() const
+  {
+    return !_size;
+  }
+
+  T& operator[](size_type index) const
+  {
+    return _data[index];
+  }
+
+  T* begin() const
+  {
+    return _data;
+  }
+
+  T* end() const
+  {
+    return _data + _size;
+  }
+
+private:
+  T *_data;
+  size_type _size;
+};
+
+//dereferencing gives a proxy, so there is no operator->
+template <typename... Fields>
+class SoAVector<Fields...>::ConstIterator
+{
+protected:
+  const SoAVector *vec;
+
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = typename SoAVector::value_type;
+  using difference_type = typename SoAVector::difference_type;
+  using pointer = void;
+  using reference = typename SoAVector::const_reference;
+
+  size_t position;
+
+  ConstIterator() : vec(nullptr), position(0) {}
+
+  explicit ConstIterator(const SoAVector &v, size_t pos) : vec(&v), position(pos) {}
+
+  reference operator*() const
+  {
+    if(this->position == vec->getSize()) throw std::out_of_range("Tried to get value of end() element");
+    return (*vec)[position];
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return (*vec)[position + d];
+  }
+
+  ConstIterator& operator++()
+  {
+    if(++(this->position) > vec->getSize()) throw std::out_of_range("Array exceeded");
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator tmp = *this;
+    ++(*this);
+    return tmp;
+  }
+
+  ConstIterator& operator--()
+  {
+    if(this->position == 0) throw std::out_of_range("Array exceeded");
+    this->position--;
+    return *this;
+  }
+
+  ConstIterator operator--(int)
+  {
+    ConstIterator tmp = *this;
+    --(*this);
+    return tmp;
+  }
+
+  ConstIterator& operator+=(difference_type d)
+  {
+    difference_type target = static_cast<difference_type>(this->position) + d;
+    if(target < 0 || target > static_cast<difference_type>(vec->getSize())) throw std::out_of_range("Array exceeded");
+    this->position = target;
+    return *this;
+  }
+
+  ConstIterator& operator-=(difference_type d)
+  {
+    return *this += -d;
+  }
+
+  ConstIterator operator+(difference_type d) const
+  {
+    ConstIterator tmp = *this;
+    return tmp += d;
+  }
+
+  friend ConstIterator operator+(difference_type d, const ConstIterator& it)
+  {
+    return it + d;
+  }
+
+  ConstIterator operator-(difference_type d) const
+  {
+    ConstIterator tmp = *this;
+    return tmp -= d;
+  }
+
+  difference_type operator-(const ConstIterator& other) const
+  {
+    return static_cast<difference_type>(this->position) - static_cast<difference_type>(other.position);
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return this->position == other.position;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+
+  bool operator<(const ConstIterator& other) const
+  {
+    return this->position < other.position;
+  }
+
+  bool operator>(const ConstIterator& other) const
+  {
+    return other < *this;
+  }
+
+  bool operator<=(const ConstIterator& other) const
+  {
+    return !(other < *this);
+  }
+
+  bool operator>=(const ConstIterator& other) const
+  {
+    return !(*this < other);
+  }
+};
+
+template <typename... Fields>
+class SoAVector<Fields...>::Iterator : public SoAVector<Fields...>::ConstIterator
+{
+public:
+  using reference = typename SoAVector::reference;
+
+  Iterator()
+  {}
+
+  Iterator(const ConstIterator& other)
+    : ConstIterator(other)
+  {}
+
+  explicit Iterator(SoAVector &v, size_t pos) : ConstIterator(v, pos) {}
+
+  Iterator& operator++()
+  {
+    ConstIterator::operator++();
+    return *this;
+  }
+
+  Iterator operator++(int)
+  {
+    auto result = *this;
+    ConstIterator::operator++();
+    return result;
+  }
+
+  Iterator& operator--()
+  {
+    ConstIterator::operator--();
+    return *this;
+  }
+
+  Iterator operator--(int)
+  {
+    auto result = *this;
+    ConstIterator::operator--();
+    return result;
+  }
+
+  Iterator& operator+=(difference_type d)
+  {
+    ConstIterator::operator+=(d);
+    return *this;
+  }
+
+  Iterator& operator-=(difference_type d)
+  {
+    ConstIterator::operator-=(d);
+    return *this;
+  }
+
+  Iterator operator+(difference_type d) const
+  {
+    return ConstIterator::operator+(d);
+  }
+
+  friend Iterator operator+(difference_type d, const Iterator& it)
+  {
+    return it + d;
+  }
+
+  Iterator operator-(difference_type d) const
+  {
+    return ConstIterator::operator-(d);
+  }
+
+  using ConstIterator::operator-;
+
+  reference operator*() const
+  {
+    ConstIterator::operator*();
+    // ugly cast, yet reduces code duplication.
+    return reference(const_cast<SoAVector&>(*this->vec), this->position);
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return reference(const_cast<SoAVector&>(*this->vec), this->position + d);
+  }
+};
+
+}
+
+#endif /* AISDI_LINEAR_SOAVECTOR_H */
@@ -0,0 +1,759 @@
+#ifndef AISDI_LINEAR_SORT_H
+#define AISDI_LINEAR_SORT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallelAlgorithms.h"
+#include "threadPool.h"
+#include "vector.h"
+
+namespace aisdi
+{
+
+//sorting of Vectors and plain arrays
+//
+//sort() is pattern-defeating quicksort: introsort that recognises sorted and
+//equal-heavy inputs, shuffles its way out of bad pivots and falls back to heapsort;
+//arithmetic types compared by std::less or std::greater partition without branches
+//(BlockQuicksort), and for them sort() and stableSort() use a radix sort instead
+//above a few thousand elements
+//sort() with ParallelOptions splits large inputs by a sample sort into buckets sorted on a
+//ThreadPool; without them everything runs on the calling thread
+//stableSort() is a merge sort, sortByKey() a stable sort by an extracted key, radix
+//sorted when the key is a number and the records are trivially copyable
+
+namespace detail
+{
+
+struct SortTuning
+{
+  static constexpr std::size_t INSERTION_SORT_THRESHOLD = 24;
+  static constexpr std::size_t NINTHER_THRESHOLD = 128;
+  //element moves after which partialInsertionSort gives up
+  static constexpr std::size_t PARTIAL_INSERTION_SORT_LIMIT = 8;
+  static constexpr std::size_t BLOCK_SIZE = 64;
+  static constexpr std::size_t CACHE_LINE = 64;
+  //elements per key byte below which pdqsort beats the histogram passes
+  static constexpr std::size_t RADIX_THRESHOLD_PER_BYTE = 2048;
+  //radix sort buckets below this are insertion sorted
+  static constexpr std::size_t RADIX_INSERTION_THRESHOLD = 64;
+  //and buckets of fewer bytes than this, which stay in the L2 cache, finished by LSD passes
+  static constexpr std::size_t RADIX_LSD_BYTES = 1 << 19;
+  static constexpr std::size_t STABLE_RUN = 32;
+  //smallest input handed to the parallel sample sort
+  static constexpr std::size_t PARALLEL_THRESHOLD = 1 << 20;
+  static constexpr std::size_t SAMPLE_OVERSAMPLING = 32;
+  static constexpr std::size_t MAX_BUCKETS = 256;
+};
+
+//--- radix keys
+
+//numbers the radix sort handles, mapped to unsigned integers of the same order
+template <typename Key>
+struct RadixTraits
+{
+  static constexpr bool supported = std::is_integral<Key>::value || std::is_same<Key, float>::value || std::is_same<Key, double>::value;
+};
+
+template <std::size_t Bytes> struct UnsignedOfSize;
+template <> struct UnsignedOfSize<1> { using type = std::uint8_t; };
+template <> struct UnsignedOfSize<2> { using type = std::uint16_t; };
+template <> struct UnsignedOfSize<4> { using type = std::uint32_t; };
+template <> struct UnsignedOfSize<8> { using type = std::uint64_t; };
+
+template <typename Key>
+using RadixUnsigned = typename UnsignedOfSize<sizeof(Key)>::type;
+
+//signed integers get the sign bit flipped; negative floats all bits, positive ones the sign
+//bit, which orders NaNs at the ends according to their sign; -0.0 compares equal to 0.0
+//and gets its key, or a stable sort would move it before the zeros it follows
+template <typename Key>
+RadixUnsigned<Key> radixKey(Key key)
+{
+  using U = RadixUnsigned<Key>;
+  constexpr U SIGN = U(1) << (sizeof(U) * 8 - 1);
+  if constexpr(std::is_floating_point<Key>::value){
+      if(key == Key(0)) key = Key(0);
+      U bits;
+      std::memcpy(&bits, &key, sizeof(bits));
+      //all ones for negative numbers, without a branch on the sign
+      U mask = U(U(0) - U(bits >> (sizeof(U) * 8 - 1))) | SIGN;
+      return bits ^ mask;
+  }
+  else if constexpr(std::is_signed<Key>::value) return static_cast<U>(key) ^ SIGN;
+  else return static_cast<U>(key);
+}
+
+//1 for std::less, -1 for std::greater over a radix sortable type, 0 for anything else
+template <typename T, typename Compare>
+struct RadixOrder : std::integral_constant<int, 0> {};
+
+template <typename T>
+struct RadixOrder<T, std::less<T>> : std::integral_constant<int, RadixTraits<T>::supported ? 1 : 0> {};
+
+template <typename T>
+struct RadixOrder<T, std::less<>> : std::integral_constant<int, RadixTraits<T>::supported ? 1 : 0> {};
+
+template <typename T>
+struct RadixOrder<T, std::greater<T>> : std::integral_constant<int, RadixTraits<T>::supported ? -1 : 0> {};
+
+template <typename T>
+struct RadixOrder<T, std::greater<>> : std::integral_constant<int, RadixTraits<T>::supported ? -1 : 0> {};
+
+//plain comparisons of numbers are cheap and unpredictable, the case block partitioning is for
+template <typename T, typename Compare>
+struct Branchless : std::integral_constant<bool, std::is_arithmetic<T>::value && RadixOrder<T, Compare>::value != 0> {};
+
+//--- pattern-defeating quicksort
+
+template <typename T, typename Compare>
+void insertionSort(T *begin, T *end, Compare& compare)
+{
+  if(begin == end) return;
+
+  for(T *current = begin + 1; current != end; ++current){
+      T *sift = current, *before = current - 1;
+      if(!compare(*sift, *before)) continue;
+
+      T item = std::move(*sift);
+      do *sift-- = std::move(*before);
+      while(sift != begin && compare(item, *--before));
+      *sift = std::move(item);
+  }
+}
+
+//the element right before begin must not be greater than any in the range, it stops the shifts
+template <typename T, typename Compare>
+void unguardedInsertionSort(T *begin, T *end, Compare& compare)
+{
+  if(begin == end) return;
+
+  for(T *current = begin + 1; current != end; ++current){
+      T *sift = current, *before = current - 1;
+      if(!compare(*sift, *before)) continue;
+
+      T item = std::move(*sift);
+      do *sift-- = std::move(*before);
+      while(compare(item, *--before));
+      *sift = std::move(item);
+  }
+}
+
+//insertion sort that gives up, returning false, once it has moved too many elements
+template <typename T, typename Compare>
+bool partialInsertionSort(T *begin, T *end, Compare& compare)
+{
+  if(begin == end) return true;
+
+  std::size_t moves = 0;
+  for(T *current = begin + 1; current != end; ++current){
+      T *sift = current, *before = current - 1;
+      if(compare(*sift, *before)){
+          T item = std::move(*sift);
+          do *sift-- = std::move(*before);
+          while(sift != begin && compare(item, *--before));
+          *sift = std::move(item);
+          moves += static_cast<std::size_t>(current - sift);
+      }
+      if(moves > SortTuning::PARTIAL_INSERTION_SORT_LIMIT) return false;
+  }
+  return true;
+}
+
+template <typename T, typename Compare>
+void sort2(T *a, T *b, Compare& compare)
+{
+  if(compare(*b, *a)) std::iter_swap(a, b);
+}
+
+template <typename T, typename Compare>
+void sort3(T *a, T *b, T *c, Compare& compare)
+{
+  sort2(a, b, compare);
+  sort2(b, c, compare);
+  sort2(a, b, compare);
+}
+
+//swaps the elements found on the wrong sides by the block partitioning; a cycle of moves
+//is cheaper than swaps, but the pairwise swaps keep descending input linear
+template <typename T>
+void swapOffsets(T *first, T *last, const unsigned char *left, const unsigned char *right, std::size_t count, bool useSwaps)
+{
+  if(useSwaps){
+      for(std::size_t i = 0; i < count; ++i) std::iter_swap(first + left[i], last - right[i]);
+  }
+  else if(count > 0){
+      T *l = first + left[0], *r = last - right[0];
+      T item = std::move(*l);
+      *l = std::move(*r);
+      for(std::size_t i = 1; i < count; ++i){
+          l = first + left[i];
+          *r = std::move(*l);
+          r = last - right[i];
+          *l = std::move(*r);
+      }
+      *r = std::move(item);
+  }
+}
+
+//partitions around *begin, elements equal to the pivot go right; returns the pivot's
+//final position and whether the range was partitioned already
+//the median of three guarantees an element not less than the pivot to its right
+template <bool UseBlocks, typename T, typename Compare>
+std::pair<T*, bool> partitionRight(T *begin, T *end, Compare& compare)
+{
+  T pivot = std::move(*begin);
+  T *first = begin, *last = end;
+
+  while(compare(*++first, pivot));
+  //with no element smaller than the pivot before first the search down must be guarded
+  if(first - 1 == begin) while(first < last && !compare(*--last, pivot));
+  else while(!compare(*--last, pivot));
+
+  bool partitioned = first >= last;
+  if(!partitioned && !UseBlocks){
+      while(first < last){
+          std::iter_swap(first, last);
+          while(compare(*++first, pivot));
+          while(!compare(*--last, pivot));
+      }
+  }
+  else if(!partitioned){
+      //BlockQuicksort: the comparisons of a block only record offsets of the misplaced
+      //elements, so the loop has no data dependent branches
+      std::iter_swap(first, last);
+      ++first;
+
+      alignas(SortTuning::CACHE_LINE) unsigned char leftOffsets[SortTuning::BLOCK_SIZE];
+      alignas(SortTuning::CACHE_LINE) unsigned char rightOffsets[SortTuning::BLOCK_SIZE];
+      T *leftBase = first, *rightBase = last;
+      std::size_t leftCount = 0, rightCount = 0, leftStart = 0, rightStart = 0;
+
+      while(first < last){
+          //blocks still holding misplaced elements are not refilled
+          std::size_t unknown = static_cast<std::size_t>(last - first);
+          std::size_t leftSplit = leftCount == 0 ? (rightCount == 0 ? unknown / 2 : unknown) : 0;
+          std::size_t rightSplit = rightCount == 0 ? unknown - leftSplit : 0;
+          if(leftSplit > SortTuning::BLOCK_SIZE) leftSplit = SortTuning::BLOCK_SIZE;
+          if(rightSplit > SortTuning::BLOCK_SIZE) rightSplit = SortTuning::BLOCK_SIZE;
+
+          for(std::size_t i = 0; i < leftSplit; ++i){
+              leftOffsets[leftCount] = static_cast<unsigned char>(i);
+              leftCount += !compare(*first, pivot);
+              ++first;
+          }
+          for(std::size_t i = 0; i < rightSplit; ){
+              rightOffsets[rightCount] = static_cast<unsigned char>(++i);
+              rightCount += compare(*--last, pivot);
+          }
+
+          std::size_t count = std::min(leftCount, rightCount);
+          swapOffsets(leftBase, rightBase, leftOffsets + leftStart, rightOffsets + rightStart, count, leftCount == rightCount);
+          leftCount -= count;
+          rightCount -= count;
+          leftStart += count;
+          rightStart += count;
+          if(leftCount == 0){
+              leftStart = 0;
+              leftBase = first;
+          }
+          if(rightCount == 0){
+              rightStart = 0;
+              rightBase = last;
+          }
+      }
+
+      //the misplaced elements left in one block go next to the boundary
+      if(leftCount){
+          const unsigned char *offsets = leftOffsets + leftStart;
+          while(leftCount--) std::iter_swap(leftBase + offsets[leftCount], --last);
+          first = last;
+      }
+      if(rightCount){
+          const unsigned char *offsets = rightOffsets + rightStart;
+          while(rightCount--) std::iter_swap(rightBase - offsets[rightCount], first++);
+          last = first;
+      }
+  }
+
+  T *pivotPosition = first - 1;
+  *begin = std::move(*pivotPosition);
+  *pivotPosition = std::move(pivot);
+  return std::make_pair(pivotPosition, partitioned);
+}
+
+//partitions around *begin with elements equal to the pivot going left, used when the
+//pivot equals the element before the range, so the whole left part needs no more sorting
+template <typename T, typename Compare>
+T* partitionLeft(T *begin, T *end, Compare& compare)
+{
+  T pivot = std::move(*begin);
+  T *first = begin, *last = end;
+
+  while(compare(pivot, *--last));
+  if(last + 1 == end) while(first < last && !compare(pivot, *++first));
+  else while(!compare(pivot, *++first));
+
+  while(first < last){
+      std::iter_swap(first, last);
+      while(compare(pivot, *--last));
+      while(!compare(pivot, *++first));
+  }
+
+  T *pivotPosition = last;
+  *begin = std::move(*pivotPosition);
+  *pivotPosition = std::move(pivot);
+  return pivotPosition;
+}
+
+//'leftmost' tells there is no element before begin to stop unguarded loops
+template <bool UseBlocks, typename T, typename Compare>
+void pdqSortLoop(T *begin, T *end, Compare& compare, int badAllowed, bool leftmost)
+{
+  using Tuning = SortTuning;
+
+  for(;;){
+      std::size_t size = static_cast<std::size_t>(end - begin);
+      if(size < Tuning::INSERTION_SORT_THRESHOLD){
+          if(leftmost) insertionSort(begin, end, compare);
+          else unguardedInsertionSort(begin, end, compare);
+          return;
+      }
+
+      //median of three, or the pseudo median of nine (Tukey's ninther) for larger ranges
+      std::size_t half = size / 2;
+      if(size > Tuning::NINTHER_THRESHOLD){
+          sort3(begin, begin + half, end - 1, compare);
+          sort3(begin + 1, begin + (half - 1), end - 2, compare);
+          sort3(begin + 2, begin + (half + 1), end - 3, compare);
+          sort3(begin + (half - 1), begin + half, begin + (half + 1), compare);
+          std::iter_swap(begin, begin + half);
+      }
+      else sort3(begin + half, begin, end - 1, compare);
+
+      //no element of the range is smaller than the one before it; if the pivot equals
+      //that one, the elements equal to the pivot are put aside in one sweep
+      if(!leftmost && !compare(*(begin - 1), *begin)){
+          begin = partitionLeft(begin, end, compare) + 1;
+          continue;
+      }
+
+      std::pair<T*, bool> partition = partitionRight<UseBlocks>(begin, end, compare);
+      T *pivot = partition.first;
+      std::size_t leftSize = static_cast<std::size_t>(pivot - begin);
+      std::size_t rightSize = static_cast<std::size_t>(end - (pivot + 1));
+
+      if(leftSize < size / 8 || rightSize < size / 8){
+          //too many bad pivots, heapsort keeps the worst case at O(n log n)
+          if(--badAllowed == 0){
+              std::make_heap(begin, end, compare);
+              std::sort_heap(begin, end, compare);
+              return;
+          }
+
+          //breaks the patterns that led to the bad pivot
+          if(leftSize >= Tuning::INSERTION_SORT_THRESHOLD){
+              std::iter_swap(begin, begin + leftSize / 4);
+              std::iter_swap(pivot - 1, pivot - leftSize / 4);
+              if(leftSize > Tuning::NINTHER_THRESHOLD){
+                  std::iter_swap(begin + 1, begin + (leftSize / 4 + 1));
+                  std::iter_swap(begin + 2, begin + (leftSize / 4 + 2));
+                  std::iter_swap(pivot - 2, pivot - (leftSize / 4 + 1));
+                  std::iter_swap(pivot - 3, pivot - (leftSize / 4 + 2));
+              }
+          }
+          if(rightSize >= Tuning::INSERTION_SORT_THRESHOLD){
+              std::iter_swap(pivot + 1, pivot + (1 + rightSize / 4));
+              std::iter_swap(end - 1, end - rightSize / 4);
+              if(rightSize > Tuning::NINTHER_THRESHOLD){
+                  std::iter_swap(pivot + 2, pivot + (2 + rightSize / 4));
+                  std::iter_swap(pivot + 3, pivot + (3 + rightSize / 4));
+                  std::iter_swap(end - 2, end - (1 + rightSize / 4));
+                  std::iter_swap(end - 3, end - (2 + rightSize / 4));
+              }
+          }
+      }
+      //a balanced partition that moved nothing hints at sorted input, worth a cheap try
+      else if(partition.second && partialInsertionSort(begin, pivot, compare) && partialInsertionSort(pivot + 1, end, compare)) return;
+
+      //recursion on the left part, the loop goes on with the right one
+      pdqSortLoop<UseBlocks>(begin, pivot, compare, badAllowed, leftmost);
+      begin = pivot + 1;
+      leftmost = false;
+  }
+}
+
+template <typename T, typename Compare>
+void pdqSort(T *first, T *last, Compare compare)
+{
+  std::size_t n = static_cast<std::size_t>(last - first);
+  if(n < 2) return;
+
+  int badAllowed = 0;
+  for(; n; n >>= 1) ++badAllowed;
+  pdqSortLoop<Branchless<T, Compare>::value>(first, last, compare, badAllowed, true);
+}
+
+//--- radix sort
+
+//LSD passes over the digits at 'shift' and below, for buckets small enough to stay in
+//cache; one read counts all digits and a digit that is the same in every key is skipped
+//data and spare are as in msdRadixSort
+template <typename T, typename Digits>
+void lsdRadixSort(T *data, T *spare, bool inRange, std::size_t n, Digits& digits, int shift)
+{
+  std::size_t count[sizeof(digits(*data))][256] = {};
+  const int passes = shift / 8 + 1;
+  for(T *it = data; it != data + n; ++it){
+      auto key = digits(*it);
+      for(int d = 0; d < passes; ++d) ++count[d][(key >> (8 * d)) & 0xff];
+  }
+
+  const auto first = digits(*data);
+  for(int d = 0; d < passes; ++d){
+      std::size_t *next = count[d];
+      if(next[(first >> (8 * d)) & 0xff] == n) continue;
+      std::size_t offset = 0;
+      for(std::size_t b = 0; b < 256; ++b){
+          std::size_t c = next[b];
+          next[b] = offset;
+          offset += c;
+      }
+      for(T *it = data; it != data + n; ++it) std::memcpy(static_cast<void*>(spare + next[(digits(*it) >> (8 * d)) & 0xff]++), it, sizeof(T));
+      std::swap(data, spare);
+      inRange = !inRange;
+  }
+  if(!inRange) std::memcpy(static_cast<void*>(spare), data, n * sizeof(T));
+}
+
+//distributes n records by the digit at 'shift' from data into spare, then every bucket by
+//the next digit back again; a digit that is the same in every key of a bucket is skipped
+//without moving anything, so random keys are sorted after about log256(n) passes
+//data and spare are the same window of the caller's range and of a buffer, 'inRange'
+//tells which is which; the sorted records are left in the caller's range
+//buckets that fit in cache are finished by lsdRadixSort, tiny ones by insertion sort;
+//the counts live on the stack
+template <typename T, typename Digits, typename Less>
+void msdRadixSort(T *data, T *spare, bool inRange, std::size_t n, Digits& digits, Less& less, int shift)
+{
+  if(n < SortTuning::RADIX_INSERTION_THRESHOLD){
+      insertionSort(data, data + n, less);
+      if(!inRange) std::memcpy(static_cast<void*>(spare), data, n * sizeof(T));
+      return;
+  }
+  if(n * sizeof(T) < SortTuning::RADIX_LSD_BYTES){
+      lsdRadixSort(data, spare, inRange, n, digits, shift);
+      return;
+  }
+
+  for(;;){
+      std::size_t count[256] = {};
+      for(T *it = data; it != data + n; ++it) ++count[(digits(*it) >> shift) & 0xff];
+
+      if(count[(digits(*data) >> shift) & 0xff] < n){
+          std::size_t start[257];
+          start[0] = 0;
+          for(std::size_t b = 0; b < 256; ++b) start[b + 1] = start[b] + count[b];
+          std::size_t *next = count;
+          std::copy(start, start + 256, next);
+          for(T *it = data; it != data + n; ++it) std::memcpy(static_cast<void*>(spare + next[(digits(*it) >> shift) & 0xff]++), it, sizeof(T));
+
+          for(std::size_t b = 0; b < 256; ++b){
+              std::size_t size = start[b + 1] - start[b];
+              if(size == 0) continue;
+              if(shift == 0 || size == 1){
+                  //a single record, or equal keys after the last digit
+                  if(inRange) std::memcpy(static_cast<void*>(data + start[b]), spare + start[b], size * sizeof(T));
+              }
+              else msdRadixSort(spare + start[b], data + start[b], !inRange, size, digits, less, shift - 8);
+          }
+          return;
+      }
+      if(shift == 0) break;
+      shift -= 8;
+  }
+  //all keys equal
+  if(!inRange) std::memcpy(static_cast<void*>(spare), data, n * sizeof(T));
+}
+
+//stable radix sort copying records bitwise between the range and a buffer
+template <typename T, typename KeyOf>
+void radixSort(T *first, T *last, KeyOf keyOf, bool descending)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "radix sort moves records bitwise");
+  using Key = typename std::decay<decltype(keyOf(*first))>::type;
+  using U = RadixUnsigned<Key>;
+
+  const std::size_t n = static_cast<std::size_t>(last - first);
+  if(n < 2) return;
+
+  auto digits = [&keyOf, descending](const T& record){
+      U key = radixKey<Key>(keyOf(record));
+      return descending ? U(~key) : key;
+  };
+  //digits(a) < digits(b) is the order being built, and insertion sort keeps it stable
+  auto less = [&digits](const T& a, const T& b){ return digits(a) < digits(b); };
+  if(n < SortTuning::RADIX_INSERTION_THRESHOLD){
+      insertionSort(first, last, less);
+      return;
+  }
+
+  std::unique_ptr<T[], void(*)(T*)> buffer(static_cast<T*>(::operator new(n * sizeof(T))), [](T *p){ ::operator delete(p); });
+  msdRadixSort(first, buffer.get(), true, n, digits, less, static_cast<int>(8 * (sizeof(U) - 1)));
+}
+
+//--- sequential dispatch
+
+template <typename T, typename Compare>
+void sequentialSort(T *first, T *last, Compare compare)
+{
+  constexpr int order = RadixOrder<T, Compare>::value;
+  if constexpr(order != 0){
+      if(static_cast<std::size_t>(last - first) >= SortTuning::RADIX_THRESHOLD_PER_BYTE * sizeof(T)){
+          radixSort(first, last, [](const T& x){ return x; }, order < 0);
+          return;
+      }
+  }
+  pdqSort(first, last, compare);
+}
+
+//bottom-up merge sort: insertion sorted runs, then merges bouncing between the range
+//and a buffer; a merge of two runs already in order is a plain move
+template <typename T, typename Compare>
+void mergeSort(T *first, T *last, Compare compare)
+{
+  const std::size_t n = static_cast<std::size_t>(last - first);
+  for(std::size_t b = 0; b < n; b += SortTuning::STABLE_RUN) insertionSort(first + b, first + std::min(n, b + SortTuning::STABLE_RUN), compare);
+  if(n <= SortTuning::STABLE_RUN) return;
+
+  MergeBuffer<T> buffer(n);
+  std::uninitialized_copy(std::make_move_iterator(first), std::make_move_iterator(last), buffer.data());
+  buffer.setConstructed(n);
+
+  T *from = buffer.data(), *to = first;
+  for(std::size_t width = SortTuning::STABLE_RUN; width < n; width *= 2){
+      for(std::size_t low = 0; low < n; low += 2 * width){
+          std::size_t middle = std::min(n, low + width), high = std::min(n, low + 2 * width);
+          if(middle == high || !compare(from[middle], from[middle - 1]))
+              std::move(from + low, from + high, to + low);
+          else std::merge(std::make_move_iterator(from + low), std::make_move_iterator(from + middle),
+                          std::make_move_iterator(from + middle), std::make_move_iterator(from + high), to + low, compare);
+      }
+      std::swap(from, to);
+  }
+  if(from != first) std::move(from, from + n, first);
+}
+
+template <typename T, typename Compare>
+void sequentialStableSort(T *first, T *last, Compare compare)
+{
+  constexpr int order = RadixOrder<T, Compare>::value;
+  if constexpr(order != 0){
+      if(static_cast<std::size_t>(last - first) >= SortTuning::RADIX_THRESHOLD_PER_BYTE * sizeof(T)){
+          radixSort(first, last, [](const T& x){ return x; }, order < 0);
+          return;
+      }
+  }
+  mergeSort(first, last, compare);
+}
+
+//--- parallel sample sort
+
+//splitters drawn from a sorted sample cut the range into buckets: every thread counts
+//its chunk's elements per bucket, the chunks are scattered into a buffer at offsets
+//from the counts, then every bucket is sorted on its own and moved back
+//returns false, doing nothing, when the input is too small for the pool
+template <typename T, typename Compare, typename BucketSort>
+bool sampleSort(T *first, T *last, Compare& compare, BucketSort bucketSort, ThreadPool& pool)
+{
+  using Tuning = SortTuning;
+
+  const std::size_t n = static_cast<std::size_t>(last - first);
+  std::size_t buckets = std::min(Tuning::MAX_BUCKETS, pool.getConcurrency() * Chunking::TASKS_PER_THREAD);
+  buckets = std::min(buckets, n / Chunking::MIN_GRAIN);
+  if(pool.getConcurrency() < 2 || buckets < 2) return false;
+
+  //a regular sample from a scrambled start, so that sorted input draws no worse splitters
+  std::size_t sampleSize = buckets * Tuning::SAMPLE_OVERSAMPLING;
+  Vector<T> sample;
+  sample.reserve(sampleSize);
+  std::size_t stride = n / sampleSize;
+  for(std::size_t i = 0; i < sampleSize; ++i) sample.append(first[i * stride + (i * 2654435761u) % stride]);
+  pdqSort(sample.data(), sample.data() + sampleSize, compare);
+  Vector<T> splitters;
+  splitters.reserve(buckets - 1);
+  for(std::size_t b = 1; b < buckets; ++b) splitters.append(sample[b * Tuning::SAMPLE_OVERSAMPLING]);
+
+  //number of splitters less than the element, a branch-free binary search
+  const T *split = splitters.data();
+  const std::size_t splitCount = buckets - 1;
+  auto bucketOf = [split, splitCount, &compare](const T& item){
+      const T *base = split;
+      std::size_t count = splitCount;
+      while(count > 0){
+          std::size_t half = count / 2;
+          bool right = compare(base[half], item);
+          base = right ? base + half + 1 : base;
+          count = right ? count - half - 1 : half;
+      }
+      return static_cast<std::size_t>(base - split);
+  };
+
+  const std::size_t chunks = pool.getConcurrency() * Chunking::TASKS_PER_THREAD;
+  auto chunkBegin = [n, chunks](std::size_t chunk){ return n / chunks * chunk + std::min(chunk, n % chunks); };
+  std::vector<unsigned char> bucketIds(n);
+  std::vector<std::size_t> counts(chunks * buckets, 0);
+  pool.run(chunks, [&](std::size_t chunk){
+      std::size_t *count = counts.data() + chunk * buckets;
+      for(std::size_t i = chunkBegin(chunk); i < chunkBegin(chunk + 1); ++i){
+          std::size_t b = bucketOf(first[i]);
+          bucketIds[i] = static_cast<unsigned char>(b);
+          ++count[b];
+      }
+  });
+
+  //bucket major offsets, chunk by chunk within a bucket
+  std::vector<std::size_t> bucketStart(buckets + 1, 0);
+  std::size_t offset = 0;
+  for(std::size_t b = 0; b < buckets; ++b){
+      bucketStart[b] = offset;
+      for(std::size_t chunk = 0; chunk < chunks; ++chunk){
+          std::size_t c = counts[chunk * buckets + b];
+          counts[chunk * buckets + b] = offset;
+          offset += c;
+      }
+  }
+  bucketStart[buckets] = n;
+
+  MergeBuffer<T> buffer(n);
+  pool.run(chunks, [&](std::size_t chunk){
+      std::size_t *next = counts.data() + chunk * buckets;
+      for(std::size_t i = chunkBegin(chunk); i < chunkBegin(chunk + 1); ++i) new (buffer.data() + next[bucketIds[i]]++) T(std::move(first[i]));
+  });
+  buffer.setConstructed(n);
+
+  pool.run(buckets, [&](std::size_t b){
+      T *begin = buffer.data() + bucketStart[b], *end = buffer.data() + bucketStart[b + 1];
+      bucketSort(begin, end);
+      std::move(begin, end, first + bucketStart[b]);
+  });
+  return true;
+}
+
+}
+
+//--- sorting of arrays
+
+template <typename T, typename Compare = std::less<T>>
+void sort(T *first, T *last, Compare compare = Compare())
+{
+  detail::sequentialSort(first, last, compare);
+}
+
+//parallel sample sort on options.pool; only done when asked for, as it may start the
+//process wide pool; inputs below a million elements and single thread pools are sorted
+//on the calling thread
+template <typename T, typename Compare>
+void sort(T *first, T *last, Compare compare, const ParallelOptions& options)
+{
+  //the splitters are copies of sampled elements
+  if constexpr(std::is_copy_constructible<T>::value){
+      if(static_cast<std::size_t>(last - first) >= detail::SortTuning::PARALLEL_THRESHOLD){
+          ThreadPool &pool = options.pool != nullptr ? *options.pool : ThreadPool::instance();
+          auto bucketSort = [&compare](T *b, T *e){ detail::sequentialSort(b, e, compare); };
+          if(detail::sampleSort(first, last, compare, bucketSort, pool)) return;
+      }
+  }
+  detail::sequentialSort(first, last, compare);
+}
+
+//keeps the order of equal elements; the buckets of a sample sort would break it, so it
+//runs on the calling thread only
+template <typename T, typename Compare = std::less<T>>
+void stableSort(T *first, T *last, Compare compare = Compare())
+{
+  detail::sequentialStableSort(first, last, compare);
+}
+
+//radix sort of numbers, ascending; stable, so equal floats keep their order
+template <typename T>
+void radixSort(T *first, T *last)
+{
+  static_assert(detail::RadixTraits<T>::supported, "radixSort sorts integers, floats and doubles");
+  detail::radixSort(first, last, [](const T& x){ return x; }, false);
+}
+
+//radix sort of trivially copyable records by the number keyOf(record), ascending; stable
+template <typename T, typename KeyOf>
+void radixSort(T *first, T *last, KeyOf keyOf)
+{
+  static_assert(detail::RadixTraits<typename std::decay<decltype(keyOf(*first))>::type>::supported,
+                "radixSort needs an integer, float or double key");
+  detail::radixSort(first, last, keyOf, false);
+}
+
+//stable sort by keyOf(record) ascending, radix sorted when it can be
+template <typename T, typename KeyOf>
+void sortByKey(T *first, T *last, KeyOf keyOf)
+{
+  using Key = typename std::decay<decltype(keyOf(*first))>::type;
+  if constexpr(detail::RadixTraits<Key>::supported && std::is_trivially_copyable<T>::value){
+      if(static_cast<std::size_t>(last - first) >= detail::SortTuning::RADIX_THRESHOLD_PER_BYTE * sizeof(Key)){
+          detail::radixSort(first, last, keyOf, false);
+          return;
+      }
+  }
+  detail::mergeSort(first, last, [&keyOf](const T& a, const T& b){ return keyOf(a) < keyOf(b); });
+}
+
+//--- sorting of Vectors
+
+template <typename Type, typename GrowthPolicy, typename Compare = std::less<Type>>
+void sort(Vector<Type, GrowthPolicy>& v, Compare compare = Compare())
+{
+  aisdi::sort(v.data(), v.data() + v.getSize(), compare);
+}
+
+template <typename Type, typename GrowthPolicy, typename Compare>
+void sort(Vector<Type, GrowthPolicy>& v, Compare compare, const ParallelOptions& options)
+{
+  aisdi::sort(v.data(), v.data() + v.getSize(), compare, options);
+}
+
+template <typename Type, typename GrowthPolicy, typename Compare = std::less<Type>>
+void stableSort(Vector<Type, GrowthPolicy>& v, Compare compare = Compare())
+{
+  aisdi::stableSort(v.data(), v.data() + v.getSize(), compare);
+}
+
+template <typename Type, typename GrowthPolicy>
+void radixSort(Vector<Type, GrowthPolicy>& v)
+{
+  aisdi::radixSort(v.data(), v.data() + v.getSize());
+}
+
+template <typename Type, typename GrowthPolicy, typename KeyOf>
+void radixSort(Vector<Type, GrowthPolicy>& v, KeyOf keyOf)
+{
+  aisdi::radixSort(v.data(), v.data() + v.getSize(), keyOf);
+}
+
+template <typename Type, typename GrowthPolicy, typename KeyOf>
+void sortByKey(Vector<Type, GrowthPolicy>& v, KeyOf keyOf)
+{
+  aisdi::sortByKey(v.data(), v.data() + v.getSize(), keyOf);
+}
+
+}
+
+#endif /* AISDI_LINEAR_SORT_H */
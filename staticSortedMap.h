@@ -0,0 +1,361 @@
+#ifndef AISDI_MAPS_STATICSORTEDMAP_H
+#define AISDI_MAPS_STATICSORTEDMAP_H
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace aisdi
+{
+
+//read-only ordered map for data that doesn't change after loading
+//keys are stored in Eytzinger (breadth-first) order in one cache-line aligned array,
+//values in a parallel one; a search is a branch-free walk down the implicit tree
+//that prefetches the cache lines of the descendants a few levels ahead
+template <typename KeyType, typename ValueType>
+class StaticSortedMap
+{
+public:
+  using key_type = KeyType;
+  using mapped_type = ValueType;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using size_type = std::size_t;
+  //elements are not stored as pairs, iterators hand out pairs of references
+  using reference = std::pair<const key_type&, const mapped_type&>;
+  using const_reference = reference;
+
+  class ConstIterator;
+  using iterator = ConstIterator;
+  using const_iterator = ConstIterator;
+
+  StaticSortedMap() : _keys(nullptr), _values(nullptr), _size(0) {}
+
+  //builds the index from any of the maps of this library (or anything with getSize(),
+  //begin() and end() iterating in strictly increasing key order)
+  template <typename Map>
+  explicit StaticSortedMap(const Map& map) : StaticSortedMap()
+  {
+    build(map.begin(), map.end(), map.getSize());
+  }
+
+  StaticSortedMap(const StaticSortedMap& other) : StaticSortedMap()
+  {
+    build(other.begin(), other.end(), other._size);
+  }
+
+  StaticSortedMap(StaticSortedMap&& other) : _keys(other._keys), _values(other._values), _size(other._size)
+  {
+    other._keys = nullptr;
+    other._values = nullptr;
+    other._size = 0;
+  }
+
+  ~StaticSortedMap(){ release(); }
+
+  StaticSortedMap& operator=(const StaticSortedMap& other)
+  {
+    if(&other == this) return *this;
+
+    StaticSortedMap copy(other);
+    return *this = std::move(copy);
+  }
+
+  StaticSortedMap& operator=(StaticSortedMap&& other)
+  {
+    if(&other == this) return *this;
+
+    release();
+    _keys = other._keys;
+    _values = other._values;
+    _size = other._size;
+    other._keys = nullptr;
+    other._values = nullptr;
+    other._size = 0;
+
+    return *this;
+  }
+
+  bool isEmpty() const
+  {
+    return !_size;
+  }
+
+  size_type getSize() const
+  {
+    return _size;
+  }
+
+  const mapped_type& valueOf(const key_type& key) const
+  {
+    size_type index = search(key);
+    if(index == 0 || key < _keys[index]) throw std::out_of_range("ValueOf didn't find the element");
+    return _values[index];
+  }
+
+  mapped_type& valueOf(const key_type& key)
+  {
+    return const_cast<mapped_type&>(static_cast<const StaticSortedMap*>(this)->valueOf(key));
+  }
+
+  bool contains(const key_type& key) const
+  {
+    size_type index = search(key);
+    return index != 0 && !(key < _keys[index]);
+  }
+
+  const_iterator find(const key_type& key) const
+  {
+    size_type index = search(key);
+    if(index == 0 || key < _keys[index]) return cend();
+    return const_iterator(this, index);
+  }
+
+  //first element whose key is not less than the given one
+  const_iterator lowerBound(const key_type& key) const
+  {
+    return const_iterator(this, search(key));
+  }
+
+  bool operator==(const StaticSortedMap& other) const
+  {
+    if(_size != other._size) return false;
+    for(const_iterator it1 = cbegin(), it2 = other.cbegin(); it1 != cend(); ++it1, ++it2)
+        if( (it1->first != it2->first) || (it1->second != it2->second) ) return false;
+    return true;
+  }
+
+  bool operator!=(const StaticSortedMap& other) const
+  {
+    return !(*this == other);
+  }
+
+  const_iterator cbegin() const
+  {
+    return const_iterator(this, _size ? leftmost(1) : 0);
+  }
+
+  const_iterator cend() const
+  {
+    return const_iterator(this, 0);
+  }
+
+  const_iterator begin() const
+  {
+    return cbegin();
+  }
+
+  const_iterator end() const
+  {
+    return cend();
+  }
+
+private:
+  static const size_type CACHE_LINE = 64;
+  //a node's descendants four levels down lie in 16 consecutive slots
+  static const size_type PREFETCH_DISTANCE = 16;
+
+  //both arrays are indexed from 1, the children of slot i are 2i and 2i+1, 0 means none
+  key_type *_keys;
+  mapped_type *_values;
+  size_type _size;
+
+  //index of the first key not less than the given one, 0 if there is none
+  size_type search(const key_type &key) const
+  {
+    size_type index = 1;
+    while(index <= _size){
+#if defined(__GNUC__)
+        __builtin_prefetch(reinterpret_cast<const char*>(_keys) + index * PREFETCH_DISTANCE * sizeof(key_type));
+#endif
+        index = 2 * index + (_keys[index] < key);
+    }
+    //every right turn appended a 1 bit, dropping them and the last left turn leads to the answer
+#if defined(__GNUC__)
+    index >>= __builtin_ffsll(~static_cast<unsigned long long>(index));
+#else
+    while(index & 1) index >>= 1;
+    index >>= 1;
+#endif
+    return index;
+  }
+
+  size_type leftmost(size_type index) const
+  {
+    while(2 * index <= _size) index *= 2;
+    return index;
+  }
+
+  size_type rightmost(size_type index) const
+  {
+    while(2 * index + 1 <= _size) index = 2 * index + 1;
+    return index;
+  }
+
+  size_type successor(size_type index) const
+  {
+    if(2 * index + 1 <= _size) return leftmost(2 * index + 1);
+    while(index & 1) index >>= 1;
+    return index >> 1;
+  }
+
+  size_type predecessor(size_type index) const
+  {
+    if(2 * index <= _size) return rightmost(2 * index);
+    while(index > 1 && !(index & 1)) index >>= 1;
+    return index >> 1;
+  }
+
+  template <typename T>
+  static T* allocateSlots(size_type count)
+  {
+    return static_cast<T*>(::operator new((count + 1) * sizeof(T), std::align_val_t(alignof(T) > CACHE_LINE ? alignof(T) : CACHE_LINE)));
+  }
+
+  template <typename T>
+  static void deallocateSlots(T *slots)
+  {
+    ::operator delete(slots, std::align_val_t(alignof(T) > CACHE_LINE ? alignof(T) : CACHE_LINE));
+  }
+
+  //walks the implicit tree in order while consuming the sorted input once
+  template <typename InputIterator>
+  void build(InputIterator first, InputIterator last, size_type count)
+  {
+    if(count == 0) return;
+
+    //the tree shape depends only on the element count
+    _size = count;
+    key_type *keys = allocateSlots<key_type>(count);
+    mapped_type *values = nullptr;
+    size_type built = 0, index = 0;
+    try{
+        values = allocateSlots<mapped_type>(count);
+        for(index = leftmost(1); first != last && built < count; ++first, index = successor(index)){
+            new (keys + index) key_type(first->first);
+            try{
+                new (values + index) mapped_type(first->second);
+            }
+            catch(...){
+                keys[index].~key_type();
+                throw;
+            }
+            ++built;
+        }
+        if(built != count) throw std::logic_error("StaticSortedMap got fewer elements than announced");
+    }
+    catch(...){
+        index = leftmost(1);
+        for(size_type i = 0; i < built; ++i, index = successor(index)){
+            keys[index].~key_type();
+            values[index].~mapped_type();
+        }
+        deallocateSlots(keys);
+        if(values != nullptr) deallocateSlots(values);
+        _size = 0;
+        throw;
+    }
+
+    _keys = keys;
+    _values = values;
+  }
+
+  void release()
+  {
+    for(size_type i = 1; i <= _size; ++i){
+        _keys[i].~key_type();
+        _values[i].~mapped_type();
+    }
+    if(_keys != nullptr) deallocateSlots(_keys);
+    if(_values != nullptr) deallocateSlots(_values);
+    _keys = nullptr;
+    _values = nullptr;
+    _size = 0;
+  }
+};
+
+template <typename KeyType, typename ValueType>
+class StaticSortedMap<KeyType, ValueType>::ConstIterator
+{
+public:
+  using reference = typename StaticSortedMap::const_reference;
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = typename StaticSortedMap::value_type;
+  using difference_type = std::ptrdiff_t;
+
+  //lets it->first and it->second work on a pair built on the fly
+  class pointer
+  {
+  public:
+    explicit pointer(const reference& r) : _r(r) {}
+    const reference* operator->() const { return &_r; }
+  private:
+    reference _r;
+  };
+
+  explicit ConstIterator(const StaticSortedMap *map = nullptr, size_type index = 0) : _map(map), _index(index) {}
+
+  ConstIterator& operator++()
+  {
+    if(_index == 0) throw std::out_of_range("Tried to iterate beyond the map");
+    _index = _map->successor(_index);
+    return *this;
+  }
+
+  ConstIterator operator++(int)
+  {
+    ConstIterator result = *this;
+    ++(*this);
+    return result;
+  }
+
+  ConstIterator& operator--()
+  {
+    if(_index == 0){
+        if(_map == nullptr || _map->_size == 0) throw std::out_of_range("Tried to iterate beyond the map");
+        _index = _map->rightmost(1);
+        return *this;
+    }
+
+    size_type previous = _map->predecessor(_index);
+    if(previous == 0) throw std::out_of_range("Tried to iterate beyond the map");
+    _index = previous;
+    return *this;
+  }
+
+  ConstIterator operator--(int)
+  {
+    ConstIterator result = *this;
+    --(*this);
+    return result;
+  }
+
+  reference operator*() const
+  {
+    if(_index == 0) throw std::out_of_range("Tried to get the value of the end()");
+    return reference(_map->_keys[_index], _map->_values[_index]);
+  }
+
+  pointer operator->() const
+  {
+    return pointer(this->operator*());
+  }
+
+  bool operator==(const ConstIterator& other) const
+  {
+    return _index == other._index;
+  }
+
+  bool operator!=(const ConstIterator& other) const
+  {
+    return !(*this == other);
+  }
+
+private:
+  const StaticSortedMap *_map;
+  size_type _index;
+};
+
+}
+
+#endif /* AISDI_MAPS_STATICSORTEDMAP_H */
@@ -0,0 +1,186 @@
+//stress test of ConcurrentSkipListMap and the EpochDomain reclaiming its nodes
+//threads insert, upsert, remove, look up and iterate over a small shared key range, so
+//the same keys are fought over all the time; every thread counts the elements it created
+//and removed per key and at the end the counts have to agree with what the map holds,
+//then all threads drain the map at once and every key must be removed exactly once
+//values encode their key, a node read after being freed shows up as a wrong value
+//(and under -fsanitize=address or thread as a report)
+//
+//  g++ -std=c++17 -O2 -pthread tests/concurrentSkipListMapStress.cpp -o stress
+//  g++ -std=c++17 -O1 -g -fsanitize=thread -pthread tests/concurrentSkipListMapStress.cpp -o stress
+//
+//usage: stress [threads] [operations per thread] [keys]
+//exits with 1 and describes the first failures if any check fails
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../concurrentSkipListMap.h"
+
+namespace
+{
+
+using Map = aisdi::ConcurrentSkipListMap<std::uint64_t, std::uint64_t>;
+
+const std::uint64_t VALUE_FACTOR = 1000;
+const unsigned long REPORTED_FAILURES = 10;
+
+std::atomic<unsigned long> failures(0);
+
+void fail(const char *what, std::uint64_t key)
+{
+  if(failures.fetch_add(1) < REPORTED_FAILURES) std::fprintf(stderr, "FAILED: %s (key %llu)\n", what, static_cast<unsigned long long>(key));
+}
+
+std::uint64_t valueFor(std::uint64_t key, std::uint64_t tag)
+{
+  return key * VALUE_FACTOR + tag % VALUE_FACTOR;
+}
+
+bool belongsTo(std::uint64_t value, std::uint64_t key)
+{
+  return value / VALUE_FACTOR == key;
+}
+
+struct Random
+{
+  std::uint64_t state;
+
+  explicit Random(std::uint64_t seed) : state(seed * 0x9E3779B97F4A7C15ull + 1) {}
+
+  std::uint64_t next()
+  {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+  }
+};
+
+//walks a stretch of the map, keys must grow and values match them
+void checkOrder(const Map &map, std::uint64_t from, unsigned steps)
+{
+  auto it = map.lowerBound(from);
+  if(it == map.end()) return;
+  if(it->first < from) fail("lowerBound returned a smaller key", from);
+
+  std::uint64_t previous = it->first;
+  if(!belongsTo(it->second, previous)) fail("lowerBound returned a foreign value", previous);
+  for(++it; it != map.end() && steps > 0; ++it, --steps){
+      if(!(previous < it->first)) fail("iteration went out of order", it->first);
+      if(!belongsTo(it->second, it->first)) fail("iteration returned a foreign value", it->first);
+      previous = it->first;
+  }
+}
+
+//created minus removed elements of every key, as seen by one thread
+void mixedWorkload(Map &map, unsigned thread, unsigned long operations, std::uint64_t keys, std::vector<long> &balance)
+{
+  Random random(thread + 1);
+  for(unsigned long i = 0; i < operations; ++i){
+      std::uint64_t r = random.next();
+      std::uint64_t key = (r >> 8) % keys;
+      switch(r % 16){
+      case 0: case 1:
+          if(map.insert(key, valueFor(key, i))) ++balance[key];
+          break;
+      case 2:
+          if(map.insertOrAssign(key, valueFor(key, i))) ++balance[key];
+          break;
+      case 3: case 4:
+          if(map.remove(key)) --balance[key];
+          break;
+      case 5: {
+          try{
+              if(!belongsTo(map.valueOf(key), key)) fail("valueOf returned a foreign value", key);
+          }
+          catch(const std::out_of_range&){}
+          break;
+      }
+      case 6:
+          if(i % 64 == 0) checkOrder(map, key, 64);
+          else checkOrder(map, key, 1);
+          break;
+      default: {
+          auto it = map.find(key);
+          if(it != map.end() && (it->first != key || !belongsTo(it->second, key))) fail("find returned a wrong element", key);
+          break;
+      }
+      }
+  }
+}
+
+void drain(Map &map, std::uint64_t keys, unsigned thread, unsigned threads, std::vector<long> &removed)
+{
+  //every thread walks all keys, starting at a different one
+  for(std::uint64_t i = 0; i < keys; ++i){
+      std::uint64_t key = (i + thread * keys / threads) % keys;
+      if(map.remove(key)) ++removed[key];
+  }
+}
+
+}
+
+int main(int argc, char **argv)
+{
+  unsigned threads = argc > 1 ? std::atoi(argv[1]) : 8;
+  unsigned long operations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000;
+  std::uint64_t keys = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1024;
+  if(threads == 0 || keys == 0){
+      std::fprintf(stderr, "usage: %s [threads] [operations per thread] [keys]\n", argv[0]);
+      return 2;
+  }
+
+  Map map;
+  std::vector<std::vector<long>> balances(threads, std::vector<long>(keys, 0));
+  std::vector<std::thread> workers;
+  for(unsigned t = 0; t < threads; ++t)
+      workers.emplace_back(mixedWorkload, std::ref(map), t, operations, keys, std::ref(balances[t]));
+  for(auto &w : workers) w.join();
+  workers.clear();
+
+  //quiescent now: the map must hold exactly the keys created once more than removed
+  std::uint64_t present = 0;
+  for(std::uint64_t key = 0; key < keys; ++key){
+      long balance = 0;
+      for(auto &b : balances) balance += b[key];
+      if(balance != 0 && balance != 1) fail("a key was created or removed twice", key);
+      if(map.contains(key) != (balance == 1)) fail("contains() disagrees with the operations done", key);
+      present += balance == 1;
+  }
+  if(map.getSize() != present) fail("getSize() disagrees with the elements present", map.getSize());
+
+  std::uint64_t counted = 0;
+  for(auto it = map.begin(); it != map.end(); ++it) ++counted;
+  if(counted != present) fail("iteration disagrees with the elements present", counted);
+  checkOrder(map, 0, static_cast<unsigned>(keys));
+
+  std::vector<std::vector<long>> removed(threads, std::vector<long>(keys, 0));
+  for(unsigned t = 0; t < threads; ++t)
+      workers.emplace_back(drain, std::ref(map), keys, t, threads, std::ref(removed[t]));
+  for(auto &w : workers) w.join();
+
+  for(std::uint64_t key = 0; key < keys; ++key){
+      long count = 0;
+      for(auto &r : removed) count += r[key];
+      long balance = 0;
+      for(auto &b : balances) balance += b[key];
+      if(count != balance) fail("draining removed a key a wrong number of times", key);
+  }
+  if(!map.isEmpty() || map.getSize() != 0) fail("the drained map is not empty", map.getSize());
+
+  unsigned long failed = failures.load();
+  if(failed){
+      std::fprintf(stderr, "%lu checks failed\n", failed);
+      return 1;
+  }
+  std::printf("ok: %u threads, %lu operations each, %llu keys, %llu left after the mixed phase\n",
+              threads, operations, static_cast<unsigned long long>(keys), static_cast<unsigned long long>(present));
+  return 0;
+}
@@ -0,0 +1,227 @@
+#ifndef AISDI_CONCURRENT_THREADPOOL_H
+#define AISDI_CONCURRENT_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace aisdi
+{
+
+//fork-join pool of worker threads, every worker owns a task queue and steals
+//from the others once its own is empty
+//run() blocks until its tasks are done and the calling thread executes tasks
+//meanwhile, so run() may be called from inside a task
+class ThreadPool
+{
+public:
+  using size_type = std::size_t;
+
+  //one thread less than the hardware offers, the caller of run() is the last one
+  static size_type defaultWorkers()
+  {
+    unsigned hardware = std::thread::hardware_concurrency();
+    return hardware > 1 ? hardware - 1 : 0;
+  }
+
+  static ThreadPool& instance()
+  {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  explicit ThreadPool(size_type workers = defaultWorkers()) : _queued(0), _nextQueue(0), _stopping(false)
+  {
+    for(size_type i = 0; i < workers; ++i) _queues.emplace_back(new Queue);
+    _workers.reserve(workers);
+    for(size_type i = 0; i < workers; ++i) _workers.emplace_back(&ThreadPool::work, this, i);
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool()
+  {
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stopping = true;
+    }
+    _wakeUp.notify_all();
+    for(auto &worker : _workers) worker.join();
+  }
+
+  //threads taking part in run(), the calling one included
+  size_type getConcurrency() const
+  {
+    return _workers.size() + 1;
+  }
+
+  //calls f(i) for every i in [0, count) and returns once all calls have finished
+  //after the first exception thrown by f the calls not yet started are skipped
+  //and the exception is rethrown here
+  template <typename F>
+  void run(size_type count, F&& f)
+  {
+    using Function = typename std::remove_reference<F>::type;
+
+    if(count == 0) return;
+    if(count == 1 || _workers.empty()){
+        for(size_type i = 0; i < count; ++i) f(i);
+        return;
+    }
+
+    Batch batch(count);
+    void *function = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+    size_type self = localIndex();
+    size_type first = self != NONE ? self : _nextQueue.fetch_add(1) % _queues.size();
+    for(size_type i = 0; i < count; ++i)
+        push((first + i) % _queues.size(), Task{&invoke<Function>, function, i, &batch});
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _wakeUp.notify_all();
+
+    Task task;
+    while(batch.pending.load(std::memory_order_acquire) != 0){
+        if(tryPop(self, task)) execute(task);
+        else std::this_thread::yield();
+    }
+    if(batch.error) std::rethrow_exception(batch.error);
+  }
+
+private:
+  static constexpr size_type NONE = static_cast<size_type>(-1);
+
+  struct Batch{
+    std::atomic<size_type> pending;
+    std::atomic<bool> failed;
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    explicit Batch(size_type count) : pending(count), failed(false) {}
+  };
+
+  struct Task{
+    void (*call)(void*, size_type);
+    void *function;
+    size_type index;
+    Batch *batch;
+  };
+
+  //the owner takes from the back, thieves from the front
+  struct Queue{
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  struct LocalWorker{
+    const ThreadPool *pool = nullptr;
+    size_type index = NONE;
+  };
+
+  std::vector<std::unique_ptr<Queue>> _queues;
+  std::vector<std::thread> _workers;
+  std::atomic<size_type> _queued;
+  std::atomic<size_type> _nextQueue;
+  std::mutex _sleepMutex;
+  std::condition_variable _wakeUp;
+  bool _stopping;
+
+  template <typename Function>
+  static void invoke(void *function, size_type index)
+  {
+    (*static_cast<Function*>(function))(index);
+  }
+
+  static LocalWorker& localWorker()
+  {
+    static thread_local LocalWorker worker;
+    return worker;
+  }
+
+  //queue of the calling thread, NONE if it isn't a worker of this pool
+  size_type localIndex() const
+  {
+    const LocalWorker &worker = localWorker();
+    return worker.pool == this ? worker.index : NONE;
+  }
+
+  void push(size_type queue, const Task& task)
+  {
+    std::lock_guard<std::mutex> lock(_queues[queue]->mutex);
+    _queues[queue]->tasks.push_back(task);
+    _queued.fetch_add(1);
+  }
+
+  bool tryPop(size_type self, Task& task)
+  {
+    if(_queued.load() == 0) return false;
+    if(self != NONE){
+        Queue &own = *_queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if(!own.tasks.empty()){
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            _queued.fetch_sub(1);
+            return true;
+        }
+    }
+    size_type start = self != NONE ? self + 1 : 0;
+    for(size_type i = 0; i < _queues.size(); ++i){
+        Queue &victim = *_queues[(start + i) % _queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if(!victim.tasks.empty()){
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            _queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+  }
+
+  static void execute(const Task& task)
+  {
+    Batch &batch = *task.batch;
+    if(!batch.failed.load(std::memory_order_relaxed)){
+        try{
+            task.call(task.function, task.index);
+        }
+        catch(...){
+            std::lock_guard<std::mutex> lock(batch.errorMutex);
+            if(!batch.error) batch.error = std::current_exception();
+            batch.failed.store(true, std::memory_order_relaxed);
+        }
+    }
+    batch.pending.fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+  void work(size_type index)
+  {
+    LocalWorker &worker = localWorker();
+    worker.pool = this;
+    worker.index = index;
+
+    Task task;
+    while(true){
+        if(tryPop(index, task)){
+            execute(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _wakeUp.wait(lock, [this]{ return _stopping || _queued.load() != 0; });
+        if(_stopping && _queued.load() == 0) return;
+    }
+  }
+};
+
+}
+
+#endif /* AISDI_CONCURRENT_THREADPOOL_H */
@@ -4,9 +4,13 @@
 #include <cstddef>
 #include <initializer_list>
 #include <stdexcept>
+#include <tuple>
 #include <utility>
+#include <vector>
 #include <iostream>
 
+#include "staticSortedMap.h"
+
 namespace aisdi
 {
 template <typename KeyType, typename ValueType>
@@ -42,17 +46,47 @@ public:
     _size = other._size;
   }
   
-  //creates the same tree hierarchy as in the 'other' tree
-  //works recursively and returns the node it creates
+  //creates the same tree hierarchy as in the 'other' tree and returns the root of the copy
+  //walks the trees by their parent pointers rather than recursing, sorted ingestion
+  //easily builds trees deeper than the stack could handle
   Node* duplicateTree(Node *source, Node *other, Node *otherMinNode, Node *otherMaxNode){
     if(other == nullptr) return nullptr;
-    
+
+    Node *root = duplicateNode(source, other, otherMinNode, otherMaxNode);
+    Node *from = other, *to = root;
+    try{
+        while(true){
+            //a missing child in the copy is one not visited yet
+            if(from->left != nullptr && to->left == nullptr){
+                to->left = duplicateNode(to, from->left, otherMinNode, otherMaxNode);
+                from = from->left;
+                to = to->left;
+            }
+            else if(from->right != nullptr && to->right == nullptr){
+                to->right = duplicateNode(to, from->right, otherMinNode, otherMaxNode);
+                from = from->right;
+                to = to->right;
+            }
+            else if(from == other) break;
+            else{
+                from = from->parent;
+                to = to->parent;
+            }
+        }
+    }
+    catch(...){
+        erase(root);
+        _minNode = _maxNode = nullptr;
+        throw;
+    }
+    return root;
+  }
+
+  Node* duplicateNode(Node *parent, Node *other, Node *otherMinNode, Node *otherMaxNode){
     Node *newNode = new Node(other->value);
     if(other == otherMinNode) _minNode = newNode;
     if(other == otherMaxNode) _maxNode = newNode;
-    newNode->parent = source;
-    newNode->left = duplicateTree(newNode, other->left, otherMinNode, otherMaxNode);
-    newNode->right = duplicateTree(newNode, other->right, otherMinNode, otherMaxNode);
+    newNode->parent = parent;
     return newNode;
   }
 
@@ -107,46 +141,32 @@ public:
 
   mapped_type& operator[](const key_type& key)
   {
-    iterator it = find(key);
-    //if element of the given key is in the tree
-    if(it != end()) return it->second;
-
-    mapped_type pom;
-    Node *newNode = new Node(std::make_pair(key, pom));
-
-    //updating minimum and maximum node
-    if(!_size || _minNode->first > key) _minNode = newNode;
-    if(!_size || _maxNode->first < key) _maxNode = newNode;
-
-    //if the tree is empty
-    if(isEmpty()){
-        _root = newNode;
-        ++_size;
-        return _root->second;
-    }
+    Node *parent;
+    bool asLeft;
+    Node *node = descend(key, parent, asLeft);
+    //if element of the given key is not in the tree
+    if(node == nullptr) node = link(parent, asLeft, key);
+    return node->second;
+  }
 
-    //if the tree is not empty
-    Node *ptr = _root;
-    while(true){
-        if(key < ptr->first){
-            if(ptr->left != nullptr) ptr = ptr->left;
-            else{
-                ptr->left = newNode;
-                break;
-            }
-        }
-        else{
-            if(ptr->right != nullptr) ptr = ptr->right;
-            else{
-                ptr->right = newNode;
-                break;
-            }
-        }
-    }
-    newNode->parent = ptr;
-    ++_size;
+  //inserts the element unless the key is already present, returns the element with the key
+  //'hint' is the position the key should precede; if it's right the insertion takes
+  //amortized O(1) instead of a descent from the root
+  iterator insert(const const_iterator& hint, const key_type& key, const mapped_type& value)
+  {
+    return emplaceHint(hint, key, value);
+  }
 
-    return newNode->second;
+  //as insert() with a hint, but the value is constructed in place from args
+  template <typename... Args>
+  iterator emplaceHint(const const_iterator& hint, const key_type& key, Args&&... args)
+  {
+    Node *parent;
+    bool asLeft;
+    Node *node = hintedPosition(hint, key, parent, asLeft);
+    if(node == nullptr && parent == nullptr) node = descend(key, parent, asLeft);
+    if(node == nullptr) node = link(parent, asLeft, key, std::forward<Args>(args)...);
+    return iterator(node, false);
   }
 
   const mapped_type& valueOf(const key_type& key) const
@@ -165,16 +185,60 @@ public:
 
   const_iterator find(const key_type& key) const
   {
-    const_iterator c_it = cbegin();
-    while(c_it != cend() && key != c_it->first) ++c_it;
-    return c_it;
+    Node *node = lookup(key);
+    if(node == nullptr) return cend();
+    return const_iterator(node, false);
   }
 
   iterator find(const key_type& key)
   {
-    iterator it = begin();
-    while(it != end() && key != it->first) ++it;
-    return it;
+    Node *node = lookup(key);
+    if(node == nullptr) return end();
+    return iterator(node, false);
+  }
+
+  //looks up keys given in non-decreasing order, writes an iterator (cend() if missing) for each
+  //every search starts from where the previous one ended instead of from the root
+  template <typename InputIterator, typename OutputIterator>
+  OutputIterator findSorted(InputIterator first, InputIterator last, OutputIterator out) const
+  {
+    Node *finger = nullptr;
+    for(; first != last; ++first, ++out){
+        Node *node = fingerLookup(finger, *first);
+        *out = node != nullptr ? const_iterator(node, false) : cend();
+    }
+    return out;
+  }
+
+  template <typename InputIterator, typename OutputIterator>
+  OutputIterator findSorted(InputIterator first, InputIterator last, OutputIterator out)
+  {
+    Node *finger = nullptr;
+    for(; first != last; ++first, ++out){
+        Node *node = fingerLookup(finger, *first);
+        *out = node != nullptr ? iterator(node, false) : end();
+    }
+    return out;
+  }
+
+  //as findSorted(), but writes whether each key is present
+  template <typename InputIterator, typename OutputIterator>
+  OutputIterator containsSorted(InputIterator first, InputIterator last, OutputIterator out) const
+  {
+    Node *finger = nullptr;
+    for(; first != last; ++first, ++out) *out = fingerLookup(finger, *first) != nullptr;
+    return out;
+  }
+
+  //merge join with keys given in non-decreasing order: calls f(key, element) for every key present
+  template <typename InputIterator, typename Function>
+  void forEachMatch(InputIterator first, InputIterator last, Function f) const
+  {
+    Node *finger = nullptr;
+    for(; first != last; ++first){
+        Node *node = fingerLookup(finger, *first);
+        if(node != nullptr) f(*first, static_cast<const_reference>(node->value));
+    }
   }
 
   void remove(const key_type& key)
@@ -205,6 +269,7 @@ public:
         //inserting pom into toRemove's place
         if(pom->parent != toRemove){
             pom->parent->right = pom->left;
+            if(pom->left != nullptr) pom->left->parent = pom->parent;
             pom->left = toRemove->left;
         }
         else toRemove->left = nullptr;
@@ -218,6 +283,7 @@ public:
         //inserting pom into toRemove's place
         if(pom->parent != toRemove){
             pom->parent->left = pom->right;
+            if(pom->right != nullptr) pom->right->parent = pom->parent;
             pom->right = toRemove->right;
         }
         else toRemove->right = nullptr;
@@ -264,17 +330,127 @@ public:
     _root = _minNode = _maxNode = nullptr;
   }
   
+  //deletes the subtree without recursion, sorted ingestion easily builds trees
+  //deeper than the stack could handle
   void erase(Node *v){
     if(v == nullptr) return;
-    erase(v->left);
-    erase(v->right);
-    delete v;
+    Node *stop = v->parent;
+    while(v != stop){
+        if(v->left != nullptr) v = v->left;
+        else if(v->right != nullptr) v = v->right;
+        else{
+            Node *parent = v->parent;
+            if(parent != nullptr){
+                if(parent->left == v) parent->left = nullptr;
+                else parent->right = nullptr;
+            }
+            delete v;
+            v = parent;
+        }
+    }
   }
 
   size_type getSize() const
   {
     return _size;
   }
+
+  //read-only copy of the map laid out for cache-friendly searching
+  StaticSortedMap<KeyType, ValueType> freeze() const
+  {
+    return StaticSortedMap<KeyType, ValueType>(*this);
+  }
+
+  //moves every element with key not less than the given one into the returned map
+  //relinking is O(height), but the nodes keep no subtree sizes, so the parts are counted
+  //by walking both in lockstep: O(height + min(k, n - k)) for k elements below the key
+  TreeMap split(const key_type& key)
+  {
+    TreeMap upper;
+    Node *lowerRoot = nullptr, *upperRoot = nullptr;
+    splitNodes(_root, key, lowerRoot, upperRoot);
+    if(upperRoot == nullptr) return upper;
+
+    upper._root = upperRoot;
+    upper._minNode = leftmost(upperRoot);
+    upper._maxNode = _maxNode;
+    _root = lowerRoot;
+    _maxNode = lowerRoot != nullptr ? rightmost(lowerRoot) : nullptr;
+    if(lowerRoot == nullptr) _minNode = nullptr;
+
+    size_type total = _size;
+    _size = countSmallerPart(_minNode, upper._minNode, total);
+    upper._size = total - _size;
+    return upper;
+  }
+
+  //takes over all elements of a map whose keys are all less or all greater than ours
+  //the extreme node of one tree becomes the new root, so joining is O(height)
+  void join(TreeMap& other)
+  {
+    if(&other == this || other.isEmpty()) return;
+    if(isEmpty()){
+        *this = std::move(other);
+        return;
+    }
+
+    bool otherIsGreater = _maxNode->first < other._minNode->first;
+    if(!otherIsGreater && !(other._maxNode->first < _minNode->first))
+        throw std::logic_error("Joined maps' keys overlap");
+
+    if(otherIsGreater){
+        _root = joinNodes(_root, other._root, _maxNode);
+        _maxNode = other._maxNode;
+    }
+    else{
+        _root = joinNodes(other._root, _root, other._maxNode);
+        _minNode = other._minNode;
+    }
+    _size += other._size;
+
+    other._root = other._minNode = other._maxNode = nullptr;
+    other._size = 0;
+  }
+
+  //moves elements with keys in [lo, hi) into the returned map
+  //the range is cut out with two single path splits and the remaining parts joined,
+  //then only the extracted elements are counted: O(height + m) for m of them
+  TreeMap extractRange(const key_type& lo, const key_type& hi)
+  {
+    TreeMap range;
+    if(!(lo < hi) || isEmpty()) return range;
+
+    Node *below = nullptr, *rest = nullptr, *above = nullptr;
+    splitNodes(_root, lo, below, rest);
+    splitNodes(rest, hi, range._root, above);
+    _root = joinNodes(below, above);
+    if(range._root == nullptr) return range;
+
+    range._minNode = leftmost(range._root);
+    range._maxNode = rightmost(range._root);
+    for(Node *node = range._minNode; node != nullptr; node = successor(node)) ++range._size;
+    _size -= range._size;
+    _minNode = _root != nullptr ? leftmost(_root) : nullptr;
+    _maxNode = _root != nullptr ? rightmost(_root) : nullptr;
+    return range;
+  }
+
+  //moves all elements of the other map into this one, for keys present in both maps
+  //our values are kept; no node is allocated or copied
+  void merge(TreeMap& other)
+  {
+    if(&other == this || other.isEmpty()) return;
+
+    size_type duplicates = 0;
+    _root = unite(_root, other._root, duplicates);
+    _root->parent = nullptr;
+    _minNode = leftmost(_root);
+    _maxNode = rightmost(_root);
+    _size += other._size - duplicates;
+
+    other._root = other._minNode = other._maxNode = nullptr;
+    other._size = 0;
+  }
   
   void display() const
   {
@@ -334,6 +510,11 @@ private:
     Node *left, *right, *parent;
 
     Node(const value_type &v) : value(v), first(value.first), second(value.second), left(nullptr), right(nullptr), parent(nullptr) {}
+
+    template <typename... Args>
+    Node(std::piecewise_construct_t, const key_type &key, Args&&... args)
+      : value(std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)),
+        first(value.first), second(value.second), left(nullptr), right(nullptr), parent(nullptr) {}
   };
   Node *_root, *_maxNode, *_minNode;
   size_type _size;
@@ -353,6 +534,251 @@ private:
   bool isLeftChild(Node *node){
     return (node == node->parent->left);
   }
+
+  Node* lookup(const key_type &key) const {
+    Node *node = _root;
+    while(node != nullptr){
+        if(key < node->first) node = node->left;
+        else if(node->first < key) node = node->right;
+        else return node;
+    }
+    return nullptr;
+  }
+
+  //lookup of a key not less than the one searched before, 'finger' is any node on the previous path
+  //(nullptr at first) and is left on the new one; the search climbs only to the nearest ancestor
+  //whose subtree can hold the key, so close keys cost O(log distance) instead of a full descent
+  Node* fingerLookup(Node *&finger, const key_type &key) const {
+    Node *node = finger != nullptr ? finger : _root;
+    //a subtree's keys are bounded from above by the nearest ancestor holding it on its left
+    while(node != nullptr && node->parent != nullptr){
+        if(node == node->parent->left && key < node->parent->first) break;
+        node = node->parent;
+    }
+    while(node != nullptr){
+        finger = node;
+        if(key < node->first) node = node->left;
+        else if(node->first < key) node = node->right;
+        else return node;
+    }
+    return nullptr;
+  }
+
+  //returns the node holding the key, or nullptr and the place where a new node should be hooked
+  //keys beyond the current minimum or maximum are placed without descending from the root
+  Node* descend(const key_type &key, Node *&parent, bool &asLeft) const {
+    parent = nullptr;
+    asLeft = false;
+    if(_root == nullptr) return nullptr;
+
+    if(_maxNode->first < key){
+        parent = _maxNode;
+        return nullptr;
+    }
+    if(key < _minNode->first){
+        parent = _minNode;
+        asLeft = true;
+        return nullptr;
+    }
+
+    Node *node = _root;
+    while(true){
+        if(key < node->first){
+            if(node->left == nullptr) break;
+            node = node->left;
+        }
+        else if(node->first < key){
+            if(node->right == nullptr) break;
+            node = node->right;
+        }
+        else return node;
+    }
+    parent = node;
+    asLeft = key < node->first;
+    return nullptr;
+  }
+
+  //checks whether the key belongs right before the hint (or at it)
+  //leaves parent as nullptr when the hint is of no use
+  Node* hintedPosition(const const_iterator &hint, const key_type &key, Node *&parent, bool &asLeft) const {
+    parent = nullptr;
+    asLeft = false;
+    if(_root == nullptr) return nullptr;
+
+    if(hint._isEnd){
+        if(_maxNode->first < key) parent = _maxNode;
+        return nullptr;
+    }
+
+    Node *next = hint._position;
+    if(!(key < next->first)){
+        if(!(next->first < key)) return next;
+        //the key may still go right after the hint
+        Node *after = next == _maxNode ? nullptr : successor(next);
+        if(after != nullptr && !(key < after->first)) return nullptr;
+        if(next->right == nullptr) parent = next;
+        else{
+            parent = after;
+            asLeft = true;
+        }
+        return nullptr;
+    }
+
+    //the key precedes the hint, it has to come after the hint's predecessor
+    Node *before = next == _minNode ? nullptr : predecessor(next);
+    if(before != nullptr && !(before->first < key)){
+        if(!(key < before->first)) return before;
+        return nullptr;
+    }
+    if(next->left == nullptr){
+        parent = next;
+        asLeft = true;
+    }
+    else parent = before;
+    return nullptr;
+  }
+
+  //hooks a new node as a child of 'parent', the position must keep the key order
+  template <typename... Args>
+  Node* link(Node *parent, bool asLeft, const key_type &key, Args&&... args){
+    Node *newNode = new Node(std::piecewise_construct, key, std::forward<Args>(args)...);
+    newNode->parent = parent;
+
+    if(parent == nullptr) _root = newNode;
+    else if(asLeft) parent->left = newNode;
+    else parent->right = newNode;
+
+    //updating minimum and maximum node
+    if(!_size || key < _minNode->first) _minNode = newNode;
+    if(!_size || _maxNode->first < key) _maxNode = newNode;
+    ++_size;
+
+    return newNode;
+  }
+
+  static Node* leftmost(Node *node){
+    while(node->left != nullptr) node = node->left;
+    return node;
+  }
+
+  static Node* rightmost(Node *node){
+    while(node->right != nullptr) node = node->right;
+    return node;
+  }
+
+  //splits a subtree into nodes with keys less than the given one and the rest
+  //walks a single path, nodes leaving it are hooked onto the right tree
+  static void splitNodes(Node *node, const key_type &key, Node *&lower, Node *&upper){
+    Node **lowerHook = &lower, **upperHook = &upper;
+    Node *lowerParent = nullptr, *upperParent = nullptr;
+    while(node != nullptr){
+        if(node->first < key){
+            *lowerHook = node;
+            node->parent = lowerParent;
+            lowerParent = node;
+            lowerHook = &node->right;
+            node = node->right;
+        }
+        else{
+            *upperHook = node;
+            node->parent = upperParent;
+            upperParent = node;
+            upperHook = &node->left;
+            node = node->left;
+        }
+    }
+    *lowerHook = *upperHook = nullptr;
+  }
+
+  static Node* predecessor(Node *node){
+    if(node->left != nullptr) return rightmost(node->left);
+    while(node->parent != nullptr && node == node->parent->left) node = node->parent;
+    return node->parent;
+  }
+
+  static Node* successor(Node *node){
+    if(node->right != nullptr) return leftmost(node->right);
+    while(node->parent != nullptr && node == node->parent->right) node = node->parent;
+    return node->parent;
+  }
+
+  //counts the elements starting at 'first' by walking both parts in lockstep
+  //so that only the smaller one is traversed entirely
+  static size_type countSmallerPart(Node *first, Node *second, size_type total){
+    size_type steps = 0;
+    while(true){
+        if(first == nullptr) return steps;
+        if(second == nullptr) return total - steps;
+        first = successor(first);
+        second = successor(second);
+        ++steps;
+    }
+  }
+
+  //links two subtrees whose keys are all less and all greater respectively,
+  //the greatest node of the lower one becomes the root
+  static Node* joinNodes(Node *lower, Node *upper){
+    if(lower == nullptr) return upper;
+    if(upper == nullptr) return lower;
+    return joinNodes(lower, upper, rightmost(lower));
+  }
+
+  static Node* joinNodes(Node *lower, Node *upper, Node *lowerMax){
+    //detaching the greatest node of the lower tree, it has no right child
+    if(lowerMax == lower) lower = lowerMax->left;
+    else lowerMax->parent->right = lowerMax->left;
+    if(lowerMax->left != nullptr) lowerMax->left->parent = lowerMax->parent;
+
+    lowerMax->parent = nullptr;
+    lowerMax->left = lower;
+    lowerMax->right = upper;
+    if(lower != nullptr) lower->parent = lowerMax;
+    upper->parent = lowerMax;
+    return lowerMax;
+  }
+
+  //merges two subtrees, 'node' and its descendants are kept on key collisions
+  //the pairs of subtrees left to merge go on an explicit stack rather than the call
+  //stack, the trees are not balanced and can be as deep as they are large
+  static Node* unite(Node *node, Node *other, size_type &duplicates){
+    struct Pending{
+      Node *node, *other, *parent;
+      //where the merged subtree is hooked
+      Node **slot;
+    };
+
+    Node *root = nullptr;
+    std::vector<Pending> pending;
+    pending.push_back({node, other, nullptr, &root});
+    while(!pending.empty()){
+        Pending p = pending.back();
+        pending.pop_back();
+
+        Node *merged = p.node != nullptr ? p.node : p.other;
+        if(p.node != nullptr && p.other != nullptr){
+            Node *lower = nullptr, *upper = nullptr;
+            splitNodes(p.other, p.node->first, lower, upper);
+
+            //the least node of the upper part may carry the same key
+            if(upper != nullptr){
+                Node *least = leftmost(upper);
+                if(!(p.node->first < least->first)){
+                    if(least == upper) upper = least->right;
+                    else least->parent->left = least->right;
+                    if(least->right != nullptr) least->right->parent = least->parent;
+                    delete least;
+                    ++duplicates;
+                }
+            }
+
+            pending.push_back({p.node->left, lower, p.node, &p.node->left});
+            pending.push_back({p.node->right, upper, p.node, &p.node->right});
+        }
+        *p.slot = merged;
+        if(merged != nullptr) merged->parent = p.parent;
+    }
+    return root;
+  }
 };
 
 template <typename KeyType, typename ValueType>
@@ -468,6 +894,8 @@ public:
   }
 
 protected:
+  friend class TreeMap;
+
   Node *_position;
   bool _isEnd;
 
@@ -1,14 +1,57 @@
 #ifndef AISDI_LINEAR_VECTOR_H
 #define AISDI_LINEAR_VECTOR_H
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdlib>
+#include <cstring>
 #include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 namespace aisdi
 {
 
-template <typename Type>
+//growth policies of Vector: grow(capacity) gives the capacity to move to once it's full
+struct DoublingGrowth
+{
+  static std::size_t grow(std::size_t capacity)
+  {
+    return capacity ? capacity*2 : 10;
+  }
+};
+
+//wastes less memory than doubling and lets freed blocks be reused by later growth
+struct HalfGrowth
+{
+  static std::size_t grow(std::size_t capacity)
+  {
+    return capacity < 10 ? 10 : capacity + capacity/2;
+  }
+};
+
+//fixed steps for vectors whose final size is roughly known
+template <std::size_t Chunk>
+struct ChunkGrowth
+{
+  static_assert(Chunk > 0, "ChunkGrowth needs a positive chunk");
+
+  static std::size_t grow(std::size_t capacity)
+  {
+    return capacity + Chunk;
+  }
+};
+
+template <typename Type, typename GrowthPolicy = DoublingGrowth>
 class Vector
 {
 public:
@@ -27,26 +70,28 @@ public:
 
   Vector()
   {
-    this->containerPtr = new Type[10];
+    this->containerPtr = nullptr;
     this->size = 0;
-    this->maxSize = 10;
+    this->maxSize = 0;
   }
 
   Vector(std::initializer_list<Type> l) : Vector()
   {
-    for(auto i : l){
+    reallocate(l.size());
+    for(auto &i : l){
         append(i);
     }
   }
 
   Vector(const Vector& other) : Vector()
   {
+    reallocate(other.size);
     for(const_iterator i = other.begin(); i != other.end(); i++){
         append(*i);
     }
   }
 
-  Vector(Vector&& other)
+  Vector(Vector&& other) noexcept
   {
     this->containerPtr = other.containerPtr;
     this->maxSize = other.maxSize;
@@ -59,19 +104,26 @@ public:
 
   ~Vector()
   {
-      delete[] this->containerPtr;
+      destroyElements();
+      deallocate(this->containerPtr, this->maxSize);
   }
 
   Vector& operator=(const Vector& other)
   {
-    erase(this->begin(), this->end());
+    if(&other == this) return *this;
+
+    destroyElements();
+    if(this->maxSize < other.size) reallocate(other.size);
     for(const_iterator it = other.cbegin(); it != other.cend(); it++) append(*it);
     return *this;
   }
 
-  Vector& operator=(Vector&& other)
+  Vector& operator=(Vector&& other) noexcept
   {
-    erase(this->begin(), this->end());
+    if(&other == this) return *this;
+
+    destroyElements();
+    deallocate(this->containerPtr, this->maxSize);
     this->containerPtr = other.containerPtr;
     this->size = other.size, this->maxSize = other.maxSize;
     other.containerPtr = nullptr;
@@ -87,6 +139,17 @@ public:
     return containerPtr[index];
   }
 
+  //the elements are contiguous, data()[i] is the i-th one
+  const Type* data() const
+  {
+    return this->containerPtr;
+  }
+
+  Type* data()
+  {
+    return this->containerPtr;
+  }
+
   bool isEmpty() const
   {
     return (!this->size);
@@ -97,67 +160,167 @@ public:
     return this->size;
   }
 
+  size_type capacity() const
+  {
+    return this->maxSize;
+  }
+
+  //makes room for at least 'count' elements, so that filling it up doesn't reallocate
+  void reserve(size_type count)
+  {
+    if(count > this->maxSize) reallocate(count);
+  }
+
+  //releases the capacity beyond the current size
+  void shrinkToFit()
+  {
+    if(this->size < this->maxSize) reallocate(this->size);
+  }
+
   void append(const Type& item)
   {
-    if(this->size == this->maxSize){
-        Type *newContainerPtr = new Type[this->maxSize*=2];
-        for(size_type i = 0; i<this->size; i++) newContainerPtr[i] = this->containerPtr[i];
-        delete[] this->containerPtr;
-        this->containerPtr = newContainerPtr;
-    }
-    this->containerPtr[this->size] = item;
-    this->size++;
+    emplaceBack(item);
+  }
+
+  void append(Type&& item)
+  {
+    emplaceBack(std::move(item));
+  }
+
+  //the range must not come from this vector
+  template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  void append(InputIt first, InputIt last)
+  {
+    insertRange(this->size, first, last, typename std::iterator_traits<InputIt>::iterator_category());
+  }
+
+  //constructs the new last element in place from args
+  template <typename... Args>
+  Type& emplaceBack(Args&&... args)
+  {
+    if(this->size == this->maxSize) growAndEmplace(this->size, std::forward<Args>(args)...);
+    else new (this->containerPtr + this->size) Type(std::forward<Args>(args)...);
+    return this->containerPtr[this->size++];
   }
 
   void prepend(const Type& item)
   {
-    if(this->size == this->maxSize){
-        Type *newContainerPtr = new Type[this->maxSize*=2];
-        for(size_type i = 0; i<this->size; i++) newContainerPtr[i+1] = this->containerPtr[i];
-        delete []containerPtr;
-        containerPtr = newContainerPtr;
-    }
-    else{
-        for(size_type i = this->size; i>0; i--) containerPtr[i] = containerPtr[i-1];
+    emplace(cbegin(), item);
+  }
+
+  void prepend(Type&& item)
+  {
+    emplace(cbegin(), std::move(item));
+  }
+
+  void insert(const const_iterator& insertPosition, const Type& item)
+  {
+    emplace(insertPosition, item);
+  }
+
+  void insert(const const_iterator& insertPosition, Type&& item)
+  {
+    emplace(insertPosition, std::move(item));
+  }
+
+  //inserts the range before insertPosition growing and shifting the tail once,
+  //returns an iterator to the first inserted element; the range must not come from this vector
+  template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  iterator insert(const const_iterator& insertPosition, InputIt first, InputIt last)
+  {
+    size_type pos = insertPosition.position;
+    if(pos > this->size) throw std::out_of_range("Inserting beyond the end()");
+
+    insertRange(pos, first, last, typename std::iterator_traits<InputIt>::iterator_category());
+    return iterator(*this, pos);
+  }
+
+  //replaces the contents with the range, which must not come from this vector
+  template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  void assign(InputIt first, InputIt last)
+  {
+    destroyElements();
+    assignRange(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+  }
+
+  void assign(std::initializer_list<Type> l)
+  {
+    assign(l.begin(), l.end());
+  }
+
+  //new elements are value-initialized
+  void resize(size_type count)
+  {
+    if(count <= this->size){
+        truncate(count);
+        return;
     }
+    if(count > this->maxSize) reallocate(std::max(grownSize(), count));
+    for(; this->size < count; this->size++) new (this->containerPtr + this->size) Type();
+  }
 
-    this->containerPtr[0] = item;
+  void resize(size_type count, const Type& value)
+  {
+    if(count <= this->size){
+        truncate(count);
+        return;
+    }
+    if(count > this->maxSize){
+        //value may be an element of this vector
+        Type item(value);
+        reallocate(std::max(grownSize(), count));
+        for(; this->size < count; this->size++) new (this->containerPtr + this->size) Type(item);
+        return;
+    }
+    for(; this->size < count; this->size++) new (this->containerPtr + this->size) Type(value);
+  }
 
-    this->size++;
+  void clear()
+  {
+    destroyElements();
   }
 
-  void insert(const const_iterator& insertPosition, const Type& item)
+  //constructs an element in place from args right before insertPosition
+  template <typename... Args>
+  iterator emplace(const const_iterator& insertPosition, Args&&... args)
   {
+    size_type pos = insertPosition.position;
+    if(pos > this->size) throw std::out_of_range("Inserting beyond the end()");
+
+    if(pos == this->size){
+        emplaceBack(std::forward<Args>(args)...);
+        return iterator(*this, pos);
+    }
     if(this->size == this->maxSize){
-        Type *newContainerPtr = new Type[this->maxSize*=2];
-        for(size_type i = 0; i<insertPosition.position; i++) newContainerPtr[i] = this->containerPtr[i];
-        for(size_type i = insertPosition.position; i<this->size; i++) newContainerPtr[i+1] = this->containerPtr[i];
-        delete[] this->containerPtr;
-        this->containerPtr = newContainerPtr;
+        growAndEmplace(pos, std::forward<Args>(args)...);
+        this->size++;
+        return iterator(*this, pos);
     }
-    else for(size_type i = this->size; i > insertPosition.position; i--) this->containerPtr[i] = this->containerPtr[i-1];
-    this->containerPtr[insertPosition.position] = item;
+
+    //args may refer to an element of this vector, so the value is built before anything moves
+    Type item(std::forward<Args>(args)...);
+    new (this->containerPtr + this->size) Type(std::move(this->containerPtr[this->size-1]));
     this->size++;
+    for(size_type i = this->size-2; i > pos; i--) this->containerPtr[i] = std::move(this->containerPtr[i-1]);
+    this->containerPtr[pos] = std::move(item);
+    return iterator(*this, pos);
   }
 
   Type popFirst()
   {
     if(isEmpty()) throw std::logic_error("Popping element when the vector is empty");
 
-    Type value = *(this->begin());
-
-    for(size_type i = 1; i < this->size; i++){
-        this->containerPtr[i-1] = this->containerPtr[i];
-    }
-    this->size--;
-
+    Type value = std::move(this->containerPtr[0]);
+    eraseRange(0, 1);
     return value;
   }
 
   Type popLast()
   {
     if(isEmpty()) throw std::logic_error("Popping element when the vector is empty");
-    return this->containerPtr[--this->size];
+    Type value = std::move(this->containerPtr[this->size-1]);
+    this->containerPtr[--this->size].~Type();
+    return value;
   }
 
   void erase(const const_iterator& possition)
@@ -165,10 +328,7 @@ public:
     if(isEmpty()) throw std::out_of_range("Erasing when array is empty");
     if(possition.position == this->size) throw std::out_of_range("Erasing end() element");
 
-    size_type pos = possition.position;
-
-    for(size_type i = pos; i < size; i++) this->containerPtr[i] = this->containerPtr[i+1];
-    this->size--;
+    eraseRange(possition.position, possition.position + 1);
   }
 
   void erase(const const_iterator& firstIncluded, const const_iterator& lastExcluded)
@@ -176,9 +336,11 @@ public:
     if(isEmpty()) throw std::out_of_range("Erasing when array is empty");
 
     size_type pos1 = firstIncluded.position, pos2 = lastExcluded.position;
+    if(pos1 > pos2 || pos2 > this->size) throw std::out_of_range("Erasing beyond the end()");
+    //nothing to do, and moving elements onto themselves would empty them
+    if(pos1 == pos2) return;
 
-    for(size_type i = pos1, j = i+(pos2-pos1); j < this->size; i++, j++) this->containerPtr[i] = this->containerPtr[j];
-    this->size -= (pos2-pos1);
+    eraseRange(pos1, pos2);
   }
 
   iterator begin()
@@ -212,18 +374,318 @@ public:
   }
 
   private:
+    //storage is raw memory, only the first 'size' slots hold constructed elements
     pointer containerPtr;
     size_type maxSize, size;
+
+    //bitwise types are moved with memcpy and kept in malloc or mmap memory, so that the
+    //storage can grow with realloc or, once it's big, with mremap without copying
+    static const bool BITWISE = std::is_trivially_copyable<Type>::value && alignof(Type) <= alignof(std::max_align_t);
+    static const size_type MAP_THRESHOLD = 1 << 20;
+
+    static bool isMapped(size_type count)
+    {
+#if defined(__linux__)
+      return BITWISE && count * sizeof(Type) >= MAP_THRESHOLD;
+#else
+      (void)count;
+      return false;
+#endif
+    }
+
+#if defined(__linux__)
+    static size_type mappedBytes(size_type count)
+    {
+      static const size_type pageSize = sysconf(_SC_PAGESIZE);
+      return (count * sizeof(Type) + pageSize - 1) / pageSize * pageSize;
+    }
+#endif
+
+    static pointer allocate(size_type count)
+    {
+      if(BITWISE){
+#if defined(__linux__)
+          if(isMapped(count)){
+              void *p = mmap(nullptr, mappedBytes(count), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+              if(p == MAP_FAILED) throw std::bad_alloc();
+              return static_cast<pointer>(p);
+          }
+#endif
+          void *p = std::malloc(count * sizeof(Type));
+          if(p == nullptr && count) throw std::bad_alloc();
+          return static_cast<pointer>(p);
+      }
+      if(alignof(Type) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+          return static_cast<pointer>(::operator new(count * sizeof(Type), std::align_val_t(alignof(Type))));
+      return static_cast<pointer>(::operator new(count * sizeof(Type)));
+    }
+
+    //'count' is the capacity the storage was allocated with
+    static void deallocate(pointer p, size_type count)
+    {
+      if(p == nullptr) return;
+      if(BITWISE){
+#if defined(__linux__)
+          if(isMapped(count)){
+              munmap(p, mappedBytes(count));
+              return;
+          }
+#endif
+          std::free(p);
+          return;
+      }
+      (void)count;
+      if(alignof(Type) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) ::operator delete(p, std::align_val_t(alignof(Type)));
+      else ::operator delete(p);
+    }
+
+    size_type grownSize() const
+    {
+      size_type newMaxSize = GrowthPolicy::grow(this->maxSize);
+      return newMaxSize > this->maxSize ? newMaxSize : this->maxSize + 1;
+    }
+
+    void destroyElements()
+    {
+      for(size_type i = 0; i < this->size; i++) this->containerPtr[i].~Type();
+      this->size = 0;
+    }
+
+    //moves elements [from, to) of the old storage into the new one starting at 'target'
+    //copies instead when moving could throw, so a failure leaves the vector untouched
+    static void relocate(pointer from, pointer to, pointer target)
+    {
+      pointer built = target;
+      try{
+          for(; from != to; ++from, ++built) new (built) Type(std::move_if_noexcept(*from));
+      }
+      catch(...){
+          for(; target != built; ++target) target->~Type();
+          throw;
+      }
+    }
+
+    //resizes bitwise storage keeping its contents, in place when the allocator can manage
+    pointer resizeBitwise(size_type newMaxSize)
+    {
+      if(this->containerPtr == nullptr) return allocate(newMaxSize);
+
+      bool wasMapped = isMapped(this->maxSize), mapped = isMapped(newMaxSize);
+#if defined(__linux__)
+      if(wasMapped && mapped){
+          void *p = mremap(this->containerPtr, mappedBytes(this->maxSize), mappedBytes(newMaxSize), MREMAP_MAYMOVE);
+          if(p == MAP_FAILED) throw std::bad_alloc();
+          return static_cast<pointer>(p);
+      }
+#endif
+      if(!wasMapped && !mapped){
+          void *p = std::realloc(static_cast<void*>(this->containerPtr), newMaxSize * sizeof(Type));
+          if(p == nullptr) throw std::bad_alloc();
+          return static_cast<pointer>(p);
+      }
+
+      pointer newContainerPtr = allocate(newMaxSize);
+      if(this->size) std::memcpy(static_cast<void*>(newContainerPtr), this->containerPtr, this->size * sizeof(Type));
+      deallocate(this->containerPtr, this->maxSize);
+      return newContainerPtr;
+    }
+
+    //changes the capacity, which must not drop below size
+    void reallocate(size_type newMaxSize)
+    {
+      if(newMaxSize == 0){
+          deallocate(this->containerPtr, this->maxSize);
+          this->containerPtr = nullptr;
+          this->maxSize = 0;
+          return;
+      }
+      if(BITWISE){
+          this->containerPtr = resizeBitwise(newMaxSize);
+          this->maxSize = newMaxSize;
+          return;
+      }
+
+      pointer newContainerPtr = allocate(newMaxSize);
+      try{
+          relocate(this->containerPtr, this->containerPtr + this->size, newContainerPtr);
+      }
+      catch(...){
+          deallocate(newContainerPtr, newMaxSize);
+          throw;
+      }
+      size_type count = this->size;
+      destroyElements();
+      deallocate(this->containerPtr, this->maxSize);
+      this->containerPtr = newContainerPtr;
+      this->size = count;
+      this->maxSize = newMaxSize;
+    }
+
+    //grows the storage and constructs a new element at 'pos' in it; the element is built
+    //before the old ones move, as args may refer to one of them; size is left to the caller
+    template <typename... Args>
+    void growAndEmplace(size_type pos, Args&&... args)
+    {
+      size_type newMaxSize = grownSize();
+      if(BITWISE){
+          Type item(std::forward<Args>(args)...);
+          reallocate(newMaxSize);
+          std::memmove(static_cast<void*>(this->containerPtr + pos + 1), this->containerPtr + pos, (this->size - pos) * sizeof(Type));
+          new (this->containerPtr + pos) Type(std::move(item));
+          return;
+      }
+
+      growAndBuild(pos, 1, newMaxSize, [&](pointer target){ new (target) Type(std::forward<Args>(args)...); });
+    }
+
+    //moves the elements into new storage of newMaxSize leaving a gap of 'count' slots at 'pos',
+    //build(gap) fills the gap before the old elements move and cleans up after itself if it throws;
+    //size is left to the caller
+    template <typename Build>
+    void growAndBuild(size_type pos, size_type count, size_type newMaxSize, Build build)
+    {
+      pointer newContainerPtr = allocate(newMaxSize);
+      try{
+          build(newContainerPtr + pos);
+          try{
+              relocate(this->containerPtr, this->containerPtr + pos, newContainerPtr);
+              try{
+                  relocate(this->containerPtr + pos, this->containerPtr + this->size, newContainerPtr + pos + count);
+              }
+              catch(...){
+                  for(size_type i = 0; i < pos; i++) newContainerPtr[i].~Type();
+                  throw;
+              }
+          }
+          catch(...){
+              for(size_type i = 0; i < count; i++) newContainerPtr[pos + i].~Type();
+              throw;
+          }
+      }
+      catch(...){
+          deallocate(newContainerPtr, newMaxSize);
+          throw;
+      }
+      size_type oldSize = this->size;
+      destroyElements();
+      deallocate(this->containerPtr, this->maxSize);
+      this->containerPtr = newContainerPtr;
+      this->size = oldSize;
+      this->maxSize = newMaxSize;
+    }
+
+    //single pass ranges are appended one by one and rotated into place
+    template <typename InputIt>
+    void insertRange(size_type pos, InputIt first, InputIt last, std::input_iterator_tag)
+    {
+      size_type oldSize = this->size;
+      for(; first != last; ++first) emplaceBack(*first);
+      std::rotate(this->containerPtr + pos, this->containerPtr + oldSize, this->containerPtr + this->size);
+    }
+
+    template <typename ForwardIt>
+    void insertRange(size_type pos, ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+    {
+      size_type count = std::distance(first, last);
+      if(count == 0) return;
+
+      if(this->size + count > this->maxSize){
+          size_type newMaxSize = std::max(grownSize(), this->size + count);
+          if(!BITWISE){
+              growAndBuild(pos, count, newMaxSize, [&](pointer target){ std::uninitialized_copy(first, last, target); });
+              this->size += count;
+              return;
+          }
+          reallocate(newMaxSize);
+      }
+
+      pointer p = this->containerPtr;
+      size_type after = this->size - pos;
+      if(BITWISE){
+          std::memmove(static_cast<void*>(p + pos + count), p + pos, after * sizeof(Type));
+          try{
+              std::uninitialized_copy(first, last, p + pos);
+          }
+          catch(...){
+              std::memmove(static_cast<void*>(p + pos), p + pos + count, after * sizeof(Type));
+              throw;
+          }
+          this->size += count;
+          return;
+      }
+
+      //the tail is shifted by move-constructing its part that lands in raw memory
+      //and move-assigning the rest, size follows every construction
+      size_type oldSize = this->size;
+      if(after > count){
+          for(size_type i = oldSize - count; i < oldSize; i++, this->size++) new (p + this->size) Type(std::move(p[i]));
+          std::move_backward(p + pos, p + oldSize - count, p + oldSize);
+          std::copy(first, last, p + pos);
+          return;
+      }
+      ForwardIt middle = first;
+      std::advance(middle, after);
+      for(ForwardIt it = middle; it != last; ++it, this->size++) new (p + this->size) Type(*it);
+      for(size_type i = pos; i < oldSize; i++, this->size++) new (p + this->size) Type(std::move(p[i]));
+      std::copy(first, middle, p + pos);
+    }
+
+    template <typename InputIt>
+    void assignRange(InputIt first, InputIt last, std::input_iterator_tag)
+    {
+      for(; first != last; ++first) emplaceBack(*first);
+    }
+
+    //expects no elements, allocates the exact size when the capacity is too small
+    template <typename ForwardIt>
+    void assignRange(ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+    {
+      size_type count = std::distance(first, last);
+      if(count > this->maxSize){
+          deallocate(this->containerPtr, this->maxSize);
+          this->containerPtr = nullptr;
+          this->maxSize = 0;
+          this->containerPtr = allocate(count);
+          this->maxSize = count;
+      }
+      for(; first != last; ++first, this->size++) new (this->containerPtr + this->size) Type(*first);
+    }
+
+    //destroys the elements from 'count' on
+    void truncate(size_type count)
+    {
+      if(!BITWISE){
+          for(size_type i = count; i < this->size; i++) this->containerPtr[i].~Type();
+      }
+      this->size = count;
+    }
+
+    //removes [pos1, pos2) shifting the tail once, with memmove for bitwise types
+    void eraseRange(size_type pos1, size_type pos2)
+    {
+      size_type count = pos2 - pos1;
+      if(BITWISE){
+          std::memmove(static_cast<void*>(this->containerPtr + pos1), this->containerPtr + pos2, (this->size - pos2) * sizeof(Type));
+          this->size -= count;
+          return;
+      }
+      std::move(this->containerPtr + pos2, this->containerPtr + this->size, this->containerPtr + pos1);
+      truncate(this->size - count);
+    }
 };
 
-template <typename Type>
-class Vector<Type>::ConstIterator
+template <typename Type, typename GrowthPolicy>
+class Vector<Type, GrowthPolicy>::ConstIterator
 {
 protected:
-  const Vector<Type> &vec;
+  const Vector *vec;
 
 public:
-  using iterator_category = std::bidirectional_iterator_tag;
+  using iterator_category = std::random_access_iterator_tag;
+#if __cplusplus > 201703L
+  //elements are stored contiguously, so algorithms may work on data() directly
+  using iterator_concept = std::contiguous_iterator_tag;
+#endif
   using value_type = typename Vector::value_type;
   using difference_type = typename Vector::difference_type;
   using pointer = typename Vector::const_pointer;
@@ -231,17 +693,31 @@ public:
 
   size_t position;
 
-  explicit ConstIterator(const Vector &v, size_t pos) : vec(v), position(pos) {}
+  ConstIterator() : vec(nullptr), position(0) {}
+
+  explicit ConstIterator(const Vector &v, size_t pos) : vec(&v), position(pos) {}
 
   reference operator*() const
   {
-    if(this->position == vec.getSize()) throw std::out_of_range("Tried to get value of end() element");
-    return vec[position];
+    if(this->position == vec->getSize()) throw std::out_of_range("Tried to get value of end() element");
+    return (*vec)[position];
+  }
+
+  //no end check, std::to_address has to work on end() of a contiguous iterator
+  pointer operator->() const
+  {
+    return vec->data() + position;
+  }
+
+  //no range check, as with Vector::operator[]
+  reference operator[](difference_type d) const
+  {
+    return (*vec)[position + d];
   }
 
   ConstIterator& operator++()
   {
-    if(++(this->position) > vec.getSize()) throw std::out_of_range("Array exceeded");
+    if(++(this->position) > vec->getSize()) throw std::out_of_range("Array exceeded");
     return *this;
   }
 
@@ -266,18 +742,39 @@ public:
     return tmp;
   }
 
+  ConstIterator& operator+=(difference_type d)
+  {
+    difference_type target = static_cast<difference_type>(this->position) + d;
+    if(target < 0 || target > static_cast<difference_type>(vec->getSize())) throw std::out_of_range("Array exceeded");
+    this->position = target;
+    return *this;
+  }
+
+  ConstIterator& operator-=(difference_type d)
+  {
+    return *this += -d;
+  }
+
   ConstIterator operator+(difference_type d) const
   {
     ConstIterator tmp = *this;
-    for(int i = 0; i < d; i++) tmp++;
-    return tmp;
+    return tmp += d;
+  }
+
+  friend ConstIterator operator+(difference_type d, const ConstIterator& it)
+  {
+    return it + d;
   }
 
   ConstIterator operator-(difference_type d) const
   {
     ConstIterator tmp = *this;
-    for(int i = 0; i < d; i++) tmp--;
-    return tmp;
+    return tmp -= d;
+  }
+
+  difference_type operator-(const ConstIterator& other) const
+  {
+    return static_cast<difference_type>(this->position) - static_cast<difference_type>(other.position);
   }
 
   bool operator==(const ConstIterator& other) const
@@ -290,17 +787,35 @@ public:
     return !(*this == other);
   }
 
+  bool operator<(const ConstIterator& other) const
+  {
+    return this->position < other.position;
+  }
+
+  bool operator>(const ConstIterator& other) const
+  {
+    return other < *this;
+  }
+
+  bool operator<=(const ConstIterator& other) const
+  {
+    return !(other < *this);
+  }
 
+  bool operator>=(const ConstIterator& other) const
+  {
+    return !(*this < other);
+  }
 };
 
-template <typename Type>
-class Vector<Type>::Iterator : public Vector<Type>::ConstIterator
+template <typename Type, typename GrowthPolicy>
+class Vector<Type, GrowthPolicy>::Iterator : public Vector<Type, GrowthPolicy>::ConstIterator
 {
 public:
   using pointer = typename Vector::pointer;
   using reference = typename Vector::reference;
 
-  explicit Iterator()
+  Iterator()
   {}
 
   Iterator(const ConstIterator& other)
@@ -335,21 +850,50 @@ public:
     return result;
   }
 
+  Iterator& operator+=(difference_type d)
+  {
+    ConstIterator::operator+=(d);
+    return *this;
+  }
+
+  Iterator& operator-=(difference_type d)
+  {
+    ConstIterator::operator-=(d);
+    return *this;
+  }
+
   Iterator operator+(difference_type d) const
   {
     return ConstIterator::operator+(d);
   }
 
+  friend Iterator operator+(difference_type d, const Iterator& it)
+  {
+    return it + d;
+  }
+
   Iterator operator-(difference_type d) const
   {
     return ConstIterator::operator-(d);
   }
 
+  using ConstIterator::operator-;
+
   reference operator*() const
   {
     // ugly cast, yet reduces code duplication.
     return const_cast<reference>(ConstIterator::operator*());
   }
+
+  pointer operator->() const
+  {
+    return const_cast<pointer>(ConstIterator::operator->());
+  }
+
+  reference operator[](difference_type d) const
+  {
+    return const_cast<reference>(ConstIterator::operator[](d));
+  }
 };
 
 }